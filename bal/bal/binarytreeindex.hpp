@@ -31,6 +31,11 @@ namespace bal {
     
 #define _bti_item_container_item(p_item) (contains_data_itself ? ((p_item) + 3) : \
     this->p_container_->data_ + _bti_item_container_offset_ncdi(p_item))
+    
+    // item links are changed through the index so that the transaction can log them
+#define _bti_parent_offset_set(offset, value) this->transaction_set((offset), (value))
+#define _bti_right_offset_set(offset, value) this->transaction_set((offset) + 1, (value))
+#define _bti_left_offset_set(offset, value) this->transaction_set((offset) + 2, (value))
 
 
     typedef enum {btipkRoot, btipkLeft, btipkRight, btipkCurrent} binary_tree_insertion_point_kind_t;
@@ -121,8 +126,7 @@ namespace bal {
         container_offset_t container_offset;
     } avl_tree_index_item_t;
     
-    // TODO: does not implement rollback while changing matched items within the transaction bound
-    // for this implementation, this must be addressed externally e.g. by descendants
+    // changes of items within the transaction bound are undo logged, see ContainerIndex::rollback
     template<typename CONTAINER_DATA_T, bool contains_data_itself,
              typename Container<CONTAINER_DATA_T>::comparator_p comparator,
              typename BinaryTreesIndex<CONTAINER_DATA_T, avl_tree_insertion_point_t, contains_data_itself>::instance_determiner_p instance_determiner>
@@ -131,6 +135,13 @@ namespace bal {
         using base_t = BinaryTreesIndex<CONTAINER_DATA_T, avl_tree_insertion_point_t, contains_data_itself>;
         using insertion_point_t = typename base_t::insertion_point_t;
         
+        // items of an instance are iterated in comparator order
+        static constexpr bool is_ordered = true;
+        // all changes within the transaction bound are logged, rollback does not need rebuilding
+        static constexpr bool is_transaction_logged = true;
+        // building an instance only writes its own items, see build_concurrent
+        static constexpr bool is_build_concurrent = true;
+        
     private:
         // find index offset given container offset value
         // return CONTAINER_END if not found
@@ -159,22 +170,22 @@ namespace bal {
             const container_offset_t* const p_item = _bti_item(this->data_, offset);
             const container_offset_t parent_offset = _bti_item_parent_offset(p_item);
             if (parent_offset != CONTAINER_END) {
-                container_offset_t* const p_parent = _bti_item(this->data_, parent_offset);
+                const container_offset_t* const p_parent = _bti_item(this->data_, parent_offset);
                 if (offset == _bti_item_right_offset(p_parent)) {
-                    _bti_item_right_offset(p_parent) = new_offset;
+                    _bti_right_offset_set(parent_offset, new_offset);
                 } else {
                     _assert_level_1(offset == _bti_item_left_offset(p_parent));
-                    _bti_item_left_offset(p_parent) = new_offset;
+                    _bti_left_offset_set(parent_offset, new_offset);
                 };
             } else {
                 const container_offset_t instance_offset = instance_determiner(_bti_item_container_item(p_item));
                 _assert_level_1(instance_offset < this->instances_.size_);
                 _assert_level_1(this->instances_.data_[instance_offset] == offset);
-                this->instances_.data_[instance_offset] = new_offset;
+                this->transaction_set_instance(instance_offset, new_offset);
             };
             
             if (new_offset != CONTAINER_END) {
-                _bti_parent_offset(this->data_, new_offset) = parent_offset;
+                _bti_parent_offset_set(new_offset, parent_offset);
             };
         };
         
@@ -191,8 +202,8 @@ namespace bal {
                     while (_bti_left_offset(this->data_, leaf_offset) != CONTAINER_END) {
                         leaf_offset = _bti_left_offset(this->data_, leaf_offset);
                     };
-                    _bti_left_offset(this->data_, leaf_offset) = _bti_item_left_offset(p_item);
-                    _bti_parent_offset(this->data_, _bti_item_left_offset(p_item)) = leaf_offset;
+                    _bti_left_offset_set(leaf_offset, _bti_item_left_offset(p_item));
+                    _bti_parent_offset_set(_bti_item_left_offset(p_item), leaf_offset);
                 };
             } else if (_bti_item_left_offset(p_item) != CONTAINER_END) {
                 // right_offset is necessarily CONTAINER_END in this case
@@ -205,33 +216,37 @@ namespace bal {
         // replace one of the child nodes with self
         template<bool b_merge, bool b_with_left, bool b_become_left = false>
         inline void _merge_or_swap_child(const container_offset_t offset) {
-            container_offset_t* const p_item = _bti_item(this->data_, offset);
+            const container_offset_t* const p_item = _bti_item(this->data_, offset);
             container_offset_t child_offset = b_with_left ? _bti_item_left_offset(p_item) : _bti_item_right_offset(p_item);
             _assert_level_1(child_offset != CONTAINER_END);
-            container_offset_t* p_child = _bti_item(this->data_, child_offset);
+            const container_offset_t* p_child = _bti_item(this->data_, child_offset);
             const container_offset_t other_child_offset = (b_with_left ? _bti_item_right_offset(p_item) : _bti_item_left_offset(p_item));
             
             if (b_merge) {
-                _bti_item_left_offset(p_item) = _bti_item_left_offset(p_child);
+                _bti_left_offset_set(offset, _bti_item_left_offset(p_child));
                 if (_bti_item_left_offset(p_item) != CONTAINER_END) {
                     _assert_level_2(_bti_parent_offset(this->data_, _bti_item_left_offset(p_item)) == child_offset);
-                    _bti_parent_offset(this->data_, _bti_item_left_offset(p_item)) = offset;
+                    _bti_parent_offset_set(_bti_item_left_offset(p_item), offset);
                 };
-                _bti_item_right_offset(p_item) = _bti_item_right_offset(p_child);
+                _bti_right_offset_set(offset, _bti_item_right_offset(p_child));
                 if (_bti_item_right_offset(p_item) != CONTAINER_END) {
                     _assert_level_2(_bti_parent_offset(this->data_, _bti_item_right_offset(p_item)) == child_offset);
-                    _bti_parent_offset(this->data_, _bti_item_right_offset(p_item)) = offset;
+                    _bti_parent_offset_set(_bti_item_right_offset(p_item), offset);
                 };
                 p_child = p_item;
                 child_offset = offset;
             } else { // swap
                 _assert_level_1((b_become_left || _bti_item_right_offset(p_child) == CONTAINER_END) &&
                                 (!b_become_left || _bti_item_left_offset(p_child) == CONTAINER_END));
-                (b_become_left ? _bti_item_left_offset(p_child) : _bti_item_right_offset(p_child)) = _bti_item_parent_offset(p_child);
+                if (b_become_left) {
+                    _bti_left_offset_set(child_offset, _bti_item_parent_offset(p_child));
+                } else {
+                    _bti_right_offset_set(child_offset, _bti_item_parent_offset(p_child));
+                };
                 _update_parent(offset, child_offset);
-                _bti_item_parent_offset(p_item) = child_offset;
-                _bti_item_left_offset(p_item) = CONTAINER_END;
-                _bti_item_right_offset(p_item) = CONTAINER_END;
+                _bti_parent_offset_set(offset, child_offset);
+                _bti_left_offset_set(offset, CONTAINER_END);
+                _bti_right_offset_set(offset, CONTAINER_END);
             };
             
             if (other_child_offset != CONTAINER_END) {
@@ -241,8 +256,12 @@ namespace bal {
                     p_child = this->data_ + child_offset;
                 };
                 
-                (b_with_left ? _bti_item_right_offset(p_child) : _bti_item_left_offset(p_child)) = other_child_offset;
-                _bti_parent_offset(this->data_, other_child_offset) = child_offset;
+                if (b_with_left) {
+                    _bti_right_offset_set(child_offset, other_child_offset);
+                } else {
+                    _bti_left_offset_set(child_offset, other_child_offset);
+                };
+                _bti_parent_offset_set(other_child_offset, child_offset);
             };
         };
         
@@ -253,20 +272,20 @@ namespace bal {
             _assert_level_1(this->insertion_point_is_valid(insertion_point));
             this->insertion_point_invalidate();
             
-            container_offset_t* const p_item = _bti_item(this->data_, offset);
+            const container_offset_t* const p_item = _bti_item(this->data_, offset);
             
             if (insertion_point.kind == btipkCurrent) {
                 _assert_level_0(insertion_point.offset != CONTAINER_END);
                 _assert_level_0(insertion_point.container_offset != CONTAINER_END);
                 const container_offset_t* const p_original_item = _bti_item(this->data_, insertion_point.offset);
                 _update_parent(insertion_point.offset, offset);
-                _bti_item_right_offset(p_item) = _bti_item_right_offset(p_original_item);
+                _bti_right_offset_set(offset, _bti_item_right_offset(p_original_item));
                 if (_bti_item_right_offset(p_item) != CONTAINER_END) {
-                    _bti_parent_offset(this->data_, _bti_item_right_offset(p_item)) = offset;
+                    _bti_parent_offset_set(_bti_item_right_offset(p_item), offset);
                 };
-                _bti_item_left_offset(p_item) = _bti_item_left_offset(p_original_item);
+                _bti_left_offset_set(offset, _bti_item_left_offset(p_original_item));
                 if (_bti_item_left_offset(p_item) != CONTAINER_END) {
-                    _bti_parent_offset(this->data_, _bti_item_left_offset(p_item)) = offset;
+                    _bti_parent_offset_set(_bti_item_left_offset(p_item), offset);
                 };
             } else if (insertion_point.kind == btipkRoot) {
                 _assert_level_1(insertion_point.offset != CONTAINER_END);
@@ -274,33 +293,32 @@ namespace bal {
                 if (insertion_point.offset >= this->instances_.size_) {
                     this->instances_.append(CONTAINER_END, insertion_point.offset - this->instances_.size_ + 1);
                 };
-                container_offset_t* const p_offset = this->instances_.data_ + insertion_point.offset;
-                _assert_level_1(*p_offset == CONTAINER_END);
-                *p_offset = offset;
-                _bti_item_parent_offset(p_item) = CONTAINER_END;
-                _bti_item_right_offset(p_item) = CONTAINER_END;
-                _bti_item_left_offset(p_item) = CONTAINER_END;
+                _assert_level_1(this->instances_.data_[insertion_point.offset] == CONTAINER_END);
+                this->transaction_set_instance(insertion_point.offset, offset);
+                _bti_parent_offset_set(offset, CONTAINER_END);
+                _bti_right_offset_set(offset, CONTAINER_END);
+                _bti_left_offset_set(offset, CONTAINER_END);
             } else {
                 _assert_level_0(insertion_point.container_offset == CONTAINER_END);
                 _assert_level_1(insertion_point.offset < this->size_);
-                _bti_item_parent_offset(p_item) = insertion_point.offset;
-                container_offset_t* const p_parent = _bti_item(this->data_, insertion_point.offset);
+                _bti_parent_offset_set(offset, insertion_point.offset);
+                const container_offset_t* const p_parent = _bti_item(this->data_, insertion_point.offset);
                 if (insertion_point.kind == btipkLeft) {
-                    _bti_item_right_offset(p_item) = CONTAINER_END;
-                    _bti_item_left_offset(p_item) = _bti_item_left_offset(p_parent);
+                    _bti_right_offset_set(offset, CONTAINER_END);
+                    _bti_left_offset_set(offset, _bti_item_left_offset(p_parent));
                     if (_bti_item_left_offset(p_item) != CONTAINER_END) {
                         _assert_level_2(_bti_parent_offset(this->data_, _bti_item_left_offset(p_item)) == _bti_item_parent_offset(p_item));
-                        _bti_parent_offset(this->data_, _bti_item_left_offset(p_item)) = offset;
+                        _bti_parent_offset_set(_bti_item_left_offset(p_item), offset);
                     };
-                    _bti_item_left_offset(p_parent) = offset;
+                    _bti_left_offset_set(insertion_point.offset, offset);
                 } else if (insertion_point.kind == btipkRight) {
-                    _bti_item_left_offset(p_item) = CONTAINER_END;
-                    _bti_item_right_offset(p_item) = _bti_item_right_offset(p_parent);
+                    _bti_left_offset_set(offset, CONTAINER_END);
+                    _bti_right_offset_set(offset, _bti_item_right_offset(p_parent));
                     if (_bti_item_right_offset(p_item) != CONTAINER_END) {
                         _assert_level_2(_bti_parent_offset(this->data_, _bti_item_right_offset(p_item)) == _bti_item_parent_offset(p_item));
-                        _bti_parent_offset(this->data_, _bti_item_right_offset(p_item)) = offset;
+                        _bti_parent_offset_set(_bti_item_right_offset(p_item), offset);
                     };
-                    _bti_item_right_offset(p_parent) = offset;
+                    _bti_right_offset_set(insertion_point.offset, offset);
                 } else {
                     _assert_level_0(false);
                 };
@@ -389,14 +407,13 @@ namespace bal {
             _update(offset, insertion_point);
         };
         
-        /* unused
         // removes given container_offset from the index
         // fails if not found
         // keeps the element in memory but excludes it from the index
         inline void remove(const container_offset_t container_offset) {
+            this->insertion_point_invalidate();
             _remove(contains_data_itself ? container_offset : _find_container_offset(container_offset));
         };
-        */
         
         // find a match for p_object starting from the supplied index offset
         // returns container offset of the first matching object from the list if found,
@@ -480,6 +497,96 @@ namespace bal {
             return result;
         };
         
+    private:
+        // links the middle item as the root of the subtree, then its left and right halves
+        inline container_offset_t _build(const container_offset_t* const offsets, const container_size_t size, const container_offset_t parent_offset) {
+            if (size == 0) {
+                return CONTAINER_END;
+            };
+            const container_size_t middle = size >> 1;
+            const container_offset_t offset = offsets[middle];
+            container_offset_t* const p_item = _bti_item(this->data_, offset);
+            _bti_item_parent_offset(p_item) = parent_offset;
+            _bti_item_left_offset(p_item) = _build(offsets, middle, offset);
+            _bti_item_right_offset(p_item) = _build(offsets + middle + 1, size - middle - 1, offset);
+            return offset;
+        };
+
+    public:
+        // builds a balanced tree for an empty instance at once
+        // offsets are index offsets of the items ordered by comparator without duplicates
+        // not logged, hence not for use within a transaction
+        inline void build(const container_offset_t instance_offset, const container_offset_t* const offsets, const container_size_t size) {
+            _assert_level_1(!this->transaction_is_in());
+            this->insertion_point_invalidate();
+            if (instance_offset >= this->instances_.size_) {
+                this->instances_.append(CONTAINER_END, instance_offset - this->instances_.size_ + 1);
+            };
+            build_concurrent(instance_offset, offsets, size);
+        };
+
+        // same as build for an instance which is already within instances_
+        // only the instance root and its items are written so that different instances
+        // can be built by different threads at the same time
+        inline void build_concurrent(const container_offset_t instance_offset, const container_offset_t* const offsets, const container_size_t size) {
+            _assert_level_1(instance_offset < this->instances_.size_);
+            _assert_level_1(this->instances_.data_[instance_offset] == CONTAINER_END);
+            this->instances_.data_[instance_offset] = _build(offsets, size, CONTAINER_END);
+        };
+
+        // check if the item is linked into the tree, i.e. its parent refers to it
+        inline bool is_indexed(const container_offset_t offset) const {
+            static_assert(contains_data_itself, "not implemented");
+            _assert_level_0(offset < this->size_);
+            const CONTAINER_DATA_T* const p_item = _bti_item(this->data_, offset);
+            if (_bti_item_parent_offset(p_item) != CONTAINER_END) {
+                const CONTAINER_DATA_T* const p_parent = _bti_item(this->data_, _bti_item_parent_offset(p_item));
+                return (_bti_item_left_offset(p_parent) == offset) || (_bti_item_right_offset(p_parent) == offset);
+            } else {
+                const container_offset_t instance_offset = instance_determiner(_bti_item_container_item(p_item));
+                return instance_offset < this->instances_.size_ && this->instances_.data_[instance_offset] == offset;
+            };
+        };
+        
+        // updates references between items before they are moved according to the map
+        // removed items must not be indexed; references of other unindexed items are cleared
+        inline void remap(const ContainerOffsetsMap& map) {
+            static_assert(contains_data_itself, "not implemented");
+            this->insertion_point_invalidate();
+            // determine before any changes since the check relies on references
+            std::vector<bool> indexed(map.size());
+            for (auto i = 0; i < map.size(); i++) {
+                indexed[i] = is_indexed(map.offset(i));
+                _assert_level_1(!indexed[i] || map.new_offset(i) != CONTAINER_END);
+            };
+            for (auto i = 0; i < map.size(); i++) {
+                if (map.new_offset(i) != CONTAINER_END) {
+                    const container_offset_t offset = map.offset(i);
+                    const container_offset_t* const p_item = _bti_item(this->data_, offset);
+                    if (indexed[i]) {
+                        _bti_parent_offset_set(offset, map(_bti_item_parent_offset(p_item)));
+                        _bti_right_offset_set(offset, map(_bti_item_right_offset(p_item)));
+                        _bti_left_offset_set(offset, map(_bti_item_left_offset(p_item)));
+                    } else {
+                        _bti_parent_offset_set(offset, CONTAINER_END);
+                        _bti_right_offset_set(offset, CONTAINER_END);
+                        _bti_left_offset_set(offset, CONTAINER_END);
+                    };
+                };
+            };
+            for (auto i = 0; i < this->instances_.size_; i++) {
+                this->transaction_set_instance(i, map(this->instances_.data_[i]));
+            };
+        };
+
+        // make the insertion point refer to the item at the offset, once it is indexed
+        inline void insertion_point_set_current(insertion_point_t& insertion_point, const container_offset_t offset) const {
+            static_assert(contains_data_itself, "not implemented");
+            insertion_point.kind = btipkCurrent;
+            insertion_point.offset = offset;
+            insertion_point.container_offset = offset;
+        };
+        
         // initialize insertion point to replace the supplied container offset
         // vaidity of the item is checked by verifying its parent
         // insertion point is only updated if the offset is valid
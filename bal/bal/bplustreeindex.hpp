@@ -0,0 +1,587 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef bplustreeindex_hpp
+#define bplustreeindex_hpp
+
+#include "containerindex.hpp"
+
+namespace bal {
+    
+    // "bpt" refers to B+ tree index
+    // nodes are stored separately from the container, one tree per instance
+    // each node is a sorted array of entries, a fixed number of 32 bit words
+    //   header: size (number of entries) and leaf flag, parent node, next leaf node
+    //   entry: key prefix, 3 words, followed by the value
+    //     leaf nodes - value is the container offset of the item
+    //     inner nodes - value is the child node; the key is the smallest prefix within the child
+    //       the key of the first entry is ignored
+    // key prefix is produced from the item and must be consistent with the comparator
+    // i.e. if prefixes differ, they compare the same way as the items do
+    // items with equal prefixes are ordered using the comparator
+    // leaves of a tree are linked in order, enabling sequential iteration
+    //
+    // the index contains the data itself; it relies on 3 words in front of each data item
+    // which is the layout expected from a container index, see cnfclauses.hpp
+    // the first of those words refers to the leaf node containing the item
+    
+    static constexpr uint32_t BPT_KEY_SIZE = 3;
+    static constexpr uint32_t BPT_NODE_SIZE = 32; // words, 128 bytes, 2 cache lines
+    static constexpr uint32_t BPT_NODE_HEADER_SIZE = 4;
+    static constexpr uint32_t BPT_NODE_ENTRY_SIZE = BPT_KEY_SIZE + 1;
+    static constexpr uint32_t BPT_NODE_CAPACITY = (BPT_NODE_SIZE - BPT_NODE_HEADER_SIZE) / BPT_NODE_ENTRY_SIZE;
+    // number of entries remaining in the node when it is split
+    static constexpr uint32_t BPT_NODE_SPLIT_SIZE = (BPT_NODE_CAPACITY + 1) >> 1;
+    
+    // marks items removed from the index; container offsets never reach this value
+    static constexpr container_offset_t BPT_UNLINKED = CONTAINER_END - 1;
+    
+#define _bpt_node(p_nodes, node) ((p_nodes) + (node))
+#define _bpt_node_size(p_node) ((p_node)[0] & 0x7FFFFFFF)
+#define _bpt_node_is_leaf(p_node) (((p_node)[0] & 0x80000000) != 0)
+#define _bpt_node_header_set(p_node, size, is_leaf) (p_node)[0] = ((size) | ((is_leaf) ? 0x80000000 : 0))
+#define _bpt_node_parent(p_node) ((p_node)[1])
+#define _bpt_node_next(p_node) ((p_node)[2])
+#define _bpt_node_entry(p_node, index) ((p_node) + BPT_NODE_HEADER_SIZE + (index) * BPT_NODE_ENTRY_SIZE)
+#define _bpt_entry_key(p_entry) (p_entry)
+#define _bpt_entry_value(p_entry) ((p_entry)[BPT_KEY_SIZE])
+    
+#define _bpt_item_leaf(p_data, offset) (*((p_data) + (offset)))
+#define _bpt_container_item(p_data, offset) ((p_data) + (offset) + 3)
+    
+    inline int bpt_compare_keys(const uint32_t* const lhs, const uint32_t* const rhs) {
+        for (auto i = 0; i < BPT_KEY_SIZE; i++) {
+            if (lhs[i] != rhs[i]) {
+                return lhs[i] < rhs[i] ? -1 : 1;
+            };
+        };
+        return 0;
+    };
+    
+    typedef enum {bptipkNew, bptipkCurrent} bplus_tree_insertion_point_kind_t;
+    
+    // container_offset is the matching item for bptipkCurrent, CONTAINER_END for bptipkNew
+    // node and position identify where a new item is inserted, node is CONTAINER_END for an empty tree
+    // key and instance are kept since the item may be indexed before its data is updated
+    struct bplus_tree_insertion_point_t: container_index_insertion_point_t {
+        bplus_tree_insertion_point_kind_t kind;
+        container_offset_t node;
+        container_offset_t position;
+        container_offset_t instance;
+        uint32_t key[BPT_KEY_SIZE];
+    };
+    
+    // iterates over all items for particular instance in order
+    // used as the default iterator for BPlusTreesIndex
+    template<typename, typename>
+    class NodeTreesIndexInstanceOffsetIterator;
+    
+    template<typename CONTAINER_DATA_T, typename INSERTION_POINT_T>
+    class NodeTreesIndex: public ContainerIndex<container_offset_t, CONTAINER_DATA_T, NodeTreesIndexInstanceOffsetIterator<CONTAINER_DATA_T, INSERTION_POINT_T>, INSERTION_POINT_T> {
+    private:
+        using base_t = ContainerIndex<container_offset_t, CONTAINER_DATA_T, NodeTreesIndexInstanceOffsetIterator<CONTAINER_DATA_T, INSERTION_POINT_T>, INSERTION_POINT_T>;
+        
+        template<typename, typename>
+        friend class NodeTreesIndexInstanceOffsetIterator;
+        
+    protected:
+        Container<uint32_t> nodes_;
+        
+        inline container_offset_t first_leaf(container_offset_t node) const {
+            while (!_bpt_node_is_leaf(_bpt_node(nodes_.data_, node))) {
+                node = _bpt_entry_value(_bpt_node_entry(_bpt_node(nodes_.data_, node), 0));
+            };
+            return node;
+        };
+        
+    public:
+        NodeTreesIndex(const Container<CONTAINER_DATA_T>* const p_container): base_t(p_container) {};
+        
+        using instance_iterator_t = NodeTreesIndexInstanceOffsetIterator<CONTAINER_DATA_T, INSERTION_POINT_T>;
+    };
+    
+    template<typename CONTAINER_DATA_T, typename INSERTION_POINT_T>
+    class NodeTreesIndexInstanceOffsetIterator {
+    public:
+        using index_t = NodeTreesIndex<CONTAINER_DATA_T, INSERTION_POINT_T>;
+        
+    protected:
+        const index_t& index_;
+        container_offset_t node_ = CONTAINER_END;
+        container_offset_t position_ = 0;
+        
+        // skip empty leaves
+        inline container_offset_t value() {
+            while (node_ != CONTAINER_END && position_ >= _bpt_node_size(_bpt_node(index_.nodes_.data_, node_))) {
+                node_ = _bpt_node_next(_bpt_node(index_.nodes_.data_, node_));
+                position_ = 0;
+            };
+            return node_ == CONTAINER_END ? CONTAINER_END :
+                _bpt_entry_value(_bpt_node_entry(_bpt_node(index_.nodes_.data_, node_), position_));
+        };
+        
+    public:
+        NodeTreesIndexInstanceOffsetIterator(const index_t& index): index_(index) {};
+        
+        // positions at the first item for the given instance
+        // returns offset of the corresponding container data element or CONTAINER_END
+        inline container_offset_t first(const container_offset_t instance_offset) {
+            node_ = instance_offset >= index_.instances_.size_ ? CONTAINER_END : index_.instances_.data_[instance_offset];
+            node_ = node_ == CONTAINER_END ? CONTAINER_END : index_.first_leaf(node_);
+            position_ = 0;
+            return value();
+        };
+        
+        // moves to the next item for the stored instance
+        // returns offset of the corresponding container data element or CONTAINER_END
+        inline container_offset_t next() {
+            if (node_ != CONTAINER_END) {
+                position_++;
+            };
+            return value();
+        };
+    };
+    
+    // deleted entries are removed from leaves without merging the nodes
+    template<typename CONTAINER_DATA_T, bool contains_data_itself,
+             typename Container<CONTAINER_DATA_T>::comparator_p comparator,
+             void (*key_prefix)(const CONTAINER_DATA_T* const value, uint32_t* const key),
+             container_offset_t (*instance_determiner)(const CONTAINER_DATA_T* const value)>
+    class BPlusTreesIndex: public NodeTreesIndex<CONTAINER_DATA_T, bplus_tree_insertion_point_t> {
+        static_assert(contains_data_itself, "only implemented for the index containing the data itself");
+        
+    public:
+        using base_t = NodeTreesIndex<CONTAINER_DATA_T, bplus_tree_insertion_point_t>;
+        using insertion_point_t = bplus_tree_insertion_point_t;
+        
+        // items of an instance are iterated in comparator order
+        static constexpr bool is_ordered = true;
+        // nodes are not logged, rollback rebuilds the index, that of a savepoint as well;
+        // only unlinking of items is logged so that the same items are indexed again
+        // AvlTreesIndex is the one to use for rolling back savepoints often
+        static constexpr bool is_transaction_logged = false;
+        // nodes of all instances are allocated from the same container, instances are built one by one
+        static constexpr bool is_build_concurrent = false;
+        
+    private:
+        inline container_offset_t new_node(const bool is_leaf, const container_offset_t parent) {
+            const container_offset_t node = this->nodes_.size_;
+            this->nodes_.append(CONTAINER_END, BPT_NODE_SIZE);
+            uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+            _bpt_node_header_set(p_node, 0, is_leaf);
+            _bpt_node_parent(p_node) = parent;
+            _bpt_node_next(p_node) = CONTAINER_END;
+            return node;
+        };
+        
+        // the leaf where the key belongs or the leftmost leaf of the sequence of equal keys
+        inline container_offset_t descend(container_offset_t node, const uint32_t* const key) const {
+            const uint32_t* p_node = _bpt_node(this->nodes_.data_, node);
+            while (!_bpt_node_is_leaf(p_node)) {
+                container_offset_t i = _bpt_node_size(p_node) - 1;
+                while (i > 0 && bpt_compare_keys(_bpt_entry_key(_bpt_node_entry(p_node, i)), key) >= 0) {
+                    i--;
+                };
+                node = _bpt_entry_value(_bpt_node_entry(p_node, i));
+                p_node = _bpt_node(this->nodes_.data_, node);
+            };
+            return node;
+        };
+        
+        // finds the item matching p_object or the position to insert it at
+        // the position is within the leaf containing the last smaller item
+        inline container_offset_t lower_bound(const CONTAINER_DATA_T* const p_object, const uint32_t* const key,
+                                              const container_offset_t root,
+                                              container_offset_t& node, container_offset_t& position) const {
+            node = descend(root, key);
+            position = 0;
+            container_offset_t current_node = node;
+            while (current_node != CONTAINER_END) {
+                const uint32_t* const p_node = _bpt_node(this->nodes_.data_, current_node);
+                const container_offset_t size = _bpt_node_size(p_node);
+                for (auto i = 0; i < size; i++) {
+                    const uint32_t* const p_entry = _bpt_node_entry(p_node, i);
+                    int result = bpt_compare_keys(key, _bpt_entry_key(p_entry));
+                    if (result == 0) {
+                        result = comparator(p_object, _bpt_container_item(this->data_, _bpt_entry_value(p_entry)));
+                    };
+                    if (result > 0) {
+                        node = current_node;
+                        position = i + 1;
+                    } else if (result == 0) {
+                        node = current_node;
+                        position = i;
+                        return _bpt_entry_value(p_entry);
+                    } else {
+                        return CONTAINER_END;
+                    };
+                };
+                current_node = _bpt_node_next(p_node);
+            };
+            return CONTAINER_END;
+        };
+        
+        // position of the item within its leaf
+        inline container_offset_t locate(const container_offset_t offset, container_offset_t& node) const {
+            node = _bpt_item_leaf(this->data_, offset);
+            _assert_level_1(node != BPT_UNLINKED);
+            const uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+            for (auto i = 0; i < _bpt_node_size(p_node); i++) {
+                if (_bpt_entry_value(_bpt_node_entry(p_node, i)) == offset) {
+                    return i;
+                };
+            };
+            _assert_level_0(false);
+            return CONTAINER_END;
+        };
+        
+        inline bool is_linked(const container_offset_t offset) const {
+            return offset < this->size_ && _bpt_item_leaf(this->data_, offset) != BPT_UNLINKED;
+        };
+        
+        // moves the upper part of the node into a new one
+        // returns the new node which follows the original one
+        inline container_offset_t split(const container_offset_t node, const container_offset_t instance) {
+            const bool is_leaf = _bpt_node_is_leaf(_bpt_node(this->nodes_.data_, node));
+            const container_offset_t new_node_offset = new_node(is_leaf, _bpt_node_parent(_bpt_node(this->nodes_.data_, node)));
+            uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+            uint32_t* const p_new_node = _bpt_node(this->nodes_.data_, new_node_offset);
+            _assert_level_1(_bpt_node_size(p_node) == BPT_NODE_CAPACITY);
+            
+            const container_offset_t new_size = BPT_NODE_CAPACITY - BPT_NODE_SPLIT_SIZE;
+            std::copy(_bpt_node_entry(p_node, BPT_NODE_SPLIT_SIZE), _bpt_node_entry(p_node, BPT_NODE_CAPACITY),
+                      _bpt_node_entry(p_new_node, 0));
+            _bpt_node_header_set(p_node, BPT_NODE_SPLIT_SIZE, is_leaf);
+            _bpt_node_header_set(p_new_node, new_size, is_leaf);
+            
+            for (auto i = 0; i < new_size; i++) {
+                const container_offset_t value = _bpt_entry_value(_bpt_node_entry(p_new_node, i));
+                if (is_leaf) {
+                    _bpt_item_leaf(this->data_, value) = new_node_offset;
+                } else {
+                    _bpt_node_parent(_bpt_node(this->nodes_.data_, value)) = new_node_offset;
+                };
+            };
+            
+            if (is_leaf) {
+                _bpt_node_next(p_new_node) = _bpt_node_next(p_node);
+                _bpt_node_next(p_node) = new_node_offset;
+            };
+            
+            uint32_t key[BPT_KEY_SIZE];
+            std::copy(_bpt_entry_key(_bpt_node_entry(p_new_node, 0)), _bpt_entry_key(_bpt_node_entry(p_new_node, 0)) + BPT_KEY_SIZE, key);
+            insert_child(_bpt_node_parent(p_node), node, new_node_offset, key, instance);
+            return new_node_offset;
+        };
+        
+        // inserts an entry into the node, the node must have space
+        inline void insert_entry(const container_offset_t node, const container_offset_t position,
+                                 const uint32_t* const key, const container_offset_t value) {
+            uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+            const container_offset_t size = _bpt_node_size(p_node);
+            _assert_level_1(size < BPT_NODE_CAPACITY && position <= size);
+            std::copy_backward(_bpt_node_entry(p_node, position), _bpt_node_entry(p_node, size), _bpt_node_entry(p_node, size + 1));
+            uint32_t* const p_entry = _bpt_node_entry(p_node, position);
+            std::copy(key, key + BPT_KEY_SIZE, _bpt_entry_key(p_entry));
+            _bpt_entry_value(p_entry) = value;
+            _bpt_node_header_set(p_node, size + 1, _bpt_node_is_leaf(p_node));
+        };
+        
+        // inserts the entry splitting the node if necessary
+        // returns the node where the entry is inserted
+        inline container_offset_t insert(container_offset_t node, container_offset_t position,
+                                         const uint32_t* const key, const container_offset_t value,
+                                         const container_offset_t instance) {
+            if (_bpt_node_size(_bpt_node(this->nodes_.data_, node)) == BPT_NODE_CAPACITY) {
+                const container_offset_t new_node_offset = split(node, instance);
+                if (position > BPT_NODE_SPLIT_SIZE) {
+                    node = new_node_offset;
+                    position -= BPT_NODE_SPLIT_SIZE;
+                };
+            };
+            insert_entry(node, position, key, value);
+            return node;
+        };
+        
+        // links the new node following the child node within the parent
+        inline void insert_child(const container_offset_t parent, const container_offset_t child,
+                                 const container_offset_t new_child, const uint32_t* const key,
+                                 const container_offset_t instance) {
+            if (parent == CONTAINER_END) {
+                // new root
+                const container_offset_t root = new_node(false, CONTAINER_END);
+                uint32_t* const p_root = _bpt_node(this->nodes_.data_, root);
+                std::copy(key, key + BPT_KEY_SIZE, _bpt_entry_key(_bpt_node_entry(p_root, 0)));
+                _bpt_entry_value(_bpt_node_entry(p_root, 0)) = child;
+                std::copy(key, key + BPT_KEY_SIZE, _bpt_entry_key(_bpt_node_entry(p_root, 1)));
+                _bpt_entry_value(_bpt_node_entry(p_root, 1)) = new_child;
+                _bpt_node_header_set(p_root, 2, false);
+                _bpt_node_parent(_bpt_node(this->nodes_.data_, child)) = root;
+                _bpt_node_parent(_bpt_node(this->nodes_.data_, new_child)) = root;
+                _assert_level_1(this->instances_.data_[instance] == child);
+                this->instances_.data_[instance] = root;
+            } else {
+                const uint32_t* const p_parent = _bpt_node(this->nodes_.data_, parent);
+                container_offset_t position = 0;
+                while (_bpt_entry_value(_bpt_node_entry(p_parent, position)) != child) {
+                    position++;
+                    _assert_level_1(position < _bpt_node_size(p_parent));
+                };
+                const container_offset_t node = insert(parent, position + 1, key, new_child, instance);
+                _bpt_node_parent(_bpt_node(this->nodes_.data_, new_child)) = node;
+            };
+        };
+        
+        // excludes the item from the index
+        // returns the leaf and the position the item was removed from
+        inline void _remove(const container_offset_t offset, container_offset_t& node, container_offset_t& position) {
+            _assert_level_0(is_linked(offset));
+            position = locate(offset, node);
+            uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+            const container_offset_t size = _bpt_node_size(p_node);
+            std::copy(_bpt_node_entry(p_node, position + 1), _bpt_node_entry(p_node, size), _bpt_node_entry(p_node, position));
+            _bpt_node_header_set(p_node, size - 1, true);
+            this->transaction_set(offset, BPT_UNLINKED);
+        };
+        
+    protected:
+        void rollback(const container_size_t size,
+                      const container_size_t instances_size,
+                      const container_size_t container_size) override {
+            // nodes are rebuilt by the descendant
+            _assert_level_0(size == 0);
+            base_t::rollback(size, instances_size, container_size);
+            this->nodes_.size_ = 0;
+        };
+        
+        // insert the provided index element (offset) as specified by the insertion point
+        // bptipkCurrent replaces the matching item which is excluded from the index
+        inline void _update(const container_offset_t offset, const insertion_point_t& insertion_point) {
+            _assert_level_1(this->insertion_point_is_valid(insertion_point));
+            this->insertion_point_invalidate();
+            
+            if (insertion_point.kind == bptipkCurrent) {
+                _assert_level_0(insertion_point.container_offset != CONTAINER_END);
+                _assert_level_0(insertion_point.container_offset != offset);
+                container_offset_t node;
+                const container_offset_t position = locate(insertion_point.container_offset, node);
+                _bpt_entry_value(_bpt_node_entry(_bpt_node(this->nodes_.data_, node), position)) = offset;
+                _bpt_item_leaf(this->data_, offset) = node;
+                this->transaction_set(insertion_point.container_offset, BPT_UNLINKED);
+            } else {
+                _assert_level_0(insertion_point.container_offset == CONTAINER_END);
+                container_offset_t node = insertion_point.node;
+                if (node == CONTAINER_END) {
+                    const container_offset_t instance_offset = insertion_point.instance;
+                    if (instance_offset >= this->instances_.size_) {
+                        this->instances_.append(CONTAINER_END, instance_offset - this->instances_.size_ + 1);
+                    };
+                    _assert_level_1(this->instances_.data_[instance_offset] == CONTAINER_END);
+                    node = new_node(true, CONTAINER_END);
+                    this->instances_.data_[instance_offset] = node;
+                };
+                node = insert(node, insertion_point.position, insertion_point.key, offset, insertion_point.instance);
+                _bpt_item_leaf(this->data_, offset) = node;
+            };
+        };
+        
+    public:
+        BPlusTreesIndex(): base_t(this) {};
+        
+        size_t memory_size() const override {
+            return base_t::memory_size() + this->nodes_.memory_size();
+        };
+        
+        // index_size is the expected container size
+        void reset(const container_size_t instances_size, const container_size_t index_size) override {
+            base_t::reset(instances_size, index_size);
+            this->nodes_.reset(index_size >> 2);
+        };
+        
+        inline void snapshot(const BPlusTreesIndex& other) {
+            base_t::snapshot(other);
+            this->nodes_ = other.nodes_;
+        };
+        
+        // updates the index entry for a given container_offset
+        // ensuring it is removed from the previous location and
+        // is located according to the provided insertion_point
+        inline void update(const container_offset_t container_offset, const insertion_point_t& insertion_point) {
+            _assert_level_0(insertion_point.kind != bptipkCurrent || insertion_point.container_offset != container_offset);
+            insertion_point_t target = insertion_point;
+            container_offset_t node;
+            container_offset_t position;
+            _remove(container_offset, node, position);
+            // removal shifts the following entries
+            if (target.kind == bptipkNew && target.node == node && target.position > position) {
+                target.position--;
+            };
+            _update(container_offset, target);
+        };
+        
+        // excludes the item from the index; the leaf is kept even if it becomes empty
+        inline void remove(const container_offset_t container_offset) {
+            this->insertion_point_invalidate();
+            container_offset_t node;
+            container_offset_t position;
+            _remove(container_offset, node, position);
+        };
+        
+        // an insertion point referring to an item remains valid for as long as the item is indexed
+        bool insertion_point_is_valid(const insertion_point_t& insertion_point) const override {
+            bool result = base_t::insertion_point_is_valid(insertion_point);
+            if (!result && insertion_point.version_stamp != CONTAINER_END && insertion_point.kind == bptipkCurrent) {
+                result = is_linked(insertion_point.container_offset);
+            };
+            return result;
+        };
+        
+        // initialize insertion point to replace the supplied container offset
+        // insertion point is only updated if the item is indexed
+        inline void insertion_point_from_container_offset(insertion_point_t& insertion_point, const container_offset_t offset) {
+            if (insertion_point.version_stamp == CONTAINER_END ||
+                insertion_point.kind != bptipkCurrent || insertion_point.container_offset != offset) {
+                if (is_linked(offset)) {
+                    this->insertion_point_init(insertion_point);
+                    insertion_point.kind = bptipkCurrent;
+                    insertion_point.container_offset = offset;
+                    key_prefix(_bpt_container_item(this->data_, offset), insertion_point.key);
+                    insertion_point.instance = instance_determiner(_bpt_container_item(this->data_, offset));
+                };
+            };
+        };
+        
+        // builds the tree for an empty instance bottom up: leaves, then each level of inner nodes
+        // entries are spread evenly so that nodes of a level differ in size by one at most
+        // offsets are ordered by comparator without duplicates
+        inline void build(const container_offset_t instance_offset, const container_offset_t* const offsets, const container_size_t size) {
+            this->insertion_point_invalidate();
+            if (instance_offset >= this->instances_.size_) {
+                this->instances_.append(CONTAINER_END, instance_offset - this->instances_.size_ + 1);
+            };
+            _assert_level_1(this->instances_.data_[instance_offset] == CONTAINER_END);
+            if (size == 0) {
+                return;
+            };
+
+            // nodes of the last built level and their smallest keys
+            std::vector<container_offset_t> level;
+            std::vector<uint32_t> keys;
+            std::vector<container_offset_t> parent_level;
+            std::vector<uint32_t> parent_keys;
+
+            container_size_t nodes_size = (size + BPT_NODE_CAPACITY - 1) / BPT_NODE_CAPACITY;
+            container_offset_t j = 0;
+            for (container_size_t i = 0; i < nodes_size; i++) {
+                const container_offset_t node = new_node(true, CONTAINER_END);
+                uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+                const container_offset_t end = (container_offset_t)((uint64_t)size * (i + 1) / nodes_size);
+                _bpt_node_header_set(p_node, end - j, true);
+                for (auto k = 0; j < end; j++, k++) {
+                    uint32_t* const p_entry = _bpt_node_entry(p_node, k);
+                    key_prefix(_bpt_container_item(this->data_, offsets[j]), _bpt_entry_key(p_entry));
+                    _bpt_entry_value(p_entry) = offsets[j];
+                    _bpt_item_leaf(this->data_, offsets[j]) = node;
+                };
+                if (!level.empty()) {
+                    _bpt_node_next(_bpt_node(this->nodes_.data_, level.back())) = node;
+                };
+                level.push_back(node);
+                keys.insert(keys.end(), _bpt_entry_key(_bpt_node_entry(p_node, 0)), _bpt_entry_key(_bpt_node_entry(p_node, 0)) + BPT_KEY_SIZE);
+            };
+
+            while (level.size() > 1) {
+                parent_level.clear();
+                parent_keys.clear();
+                nodes_size = (container_size_t)((level.size() + BPT_NODE_CAPACITY - 1) / BPT_NODE_CAPACITY);
+                j = 0;
+                for (container_size_t i = 0; i < nodes_size; i++) {
+                    const container_offset_t node = new_node(false, CONTAINER_END);
+                    uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+                    const container_offset_t end = (container_offset_t)((uint64_t)level.size() * (i + 1) / nodes_size);
+                    _bpt_node_header_set(p_node, end - j, false);
+                    for (auto k = 0; j < end; j++, k++) {
+                        uint32_t* const p_entry = _bpt_node_entry(p_node, k);
+                        std::copy(keys.data() + j * BPT_KEY_SIZE, keys.data() + (j + 1) * BPT_KEY_SIZE, _bpt_entry_key(p_entry));
+                        _bpt_entry_value(p_entry) = level[j];
+                        _bpt_node_parent(_bpt_node(this->nodes_.data_, level[j])) = node;
+                    };
+                    parent_level.push_back(node);
+                    parent_keys.insert(parent_keys.end(), _bpt_entry_key(_bpt_node_entry(p_node, 0)), _bpt_entry_key(_bpt_node_entry(p_node, 0)) + BPT_KEY_SIZE);
+                };
+                level.swap(parent_level);
+                keys.swap(parent_keys);
+            };
+
+            this->instances_.data_[instance_offset] = level[0];
+        };
+
+        inline bool is_indexed(const container_offset_t offset) const {
+            return is_linked(offset);
+        };
+
+
+        // updates references to items before they are moved according to the map
+        // removed items must not be indexed; items refer to nodes which do not move
+        inline void remap(const ContainerOffsetsMap& map) {
+            this->insertion_point_invalidate();
+            for (container_offset_t node = 0; node < this->nodes_.size_; node += BPT_NODE_SIZE) {
+                uint32_t* const p_node = _bpt_node(this->nodes_.data_, node);
+                if (_bpt_node_is_leaf(p_node)) {
+                    for (auto i = 0; i < _bpt_node_size(p_node); i++) {
+                        uint32_t* const p_entry = _bpt_node_entry(p_node, i);
+                        _bpt_entry_value(p_entry) = map(_bpt_entry_value(p_entry));
+                        _assert_level_1(_bpt_entry_value(p_entry) != CONTAINER_END);
+                    };
+                };
+            };
+        };
+
+        // make the insertion point refer to the item at the offset, once it is indexed
+        inline void insertion_point_set_current(insertion_point_t& insertion_point, const container_offset_t offset) const {
+            insertion_point.kind = bptipkCurrent;
+            insertion_point.container_offset = offset;
+        };
+        
+        inline container_offset_t find(const CONTAINER_DATA_T* const p_object) const {
+            const container_offset_t instance_offset = instance_determiner(p_object);
+            const container_offset_t root = instance_offset < this->instances_.size_ ?
+                                                this->instances_.data_[instance_offset] : CONTAINER_END;
+            if (root != CONTAINER_END) {
+                uint32_t key[BPT_KEY_SIZE];
+                key_prefix(p_object, key);
+                container_offset_t node;
+                container_offset_t position;
+                return lower_bound(p_object, key, root, node, position);
+            } else {
+                return CONTAINER_END;
+            };
+        };
+        
+        // find a match for p_object for the specific instance
+        // return container offset of the matching object if found
+        // otherwise the insertion point identifies where to insert it
+        inline void find(const CONTAINER_DATA_T* const p_object, insertion_point_t &insertion_point) const {
+            this->insertion_point_init(insertion_point);
+            insertion_point.instance = instance_determiner(p_object);
+            key_prefix(p_object, insertion_point.key);
+            const container_offset_t root = insertion_point.instance < this->instances_.size_ ?
+                                                this->instances_.data_[insertion_point.instance] : CONTAINER_END;
+            if (root != CONTAINER_END) {
+                insertion_point.container_offset = lower_bound(p_object, insertion_point.key, root,
+                                                               insertion_point.node, insertion_point.position);
+            } else {
+                insertion_point.container_offset = CONTAINER_END;
+                insertion_point.node = CONTAINER_END;
+                insertion_point.position = 0;
+            };
+            insertion_point.kind = insertion_point.container_offset == CONTAINER_END ? bptipkNew : bptipkCurrent;
+        };
+    };
+};
+
+#endif /* bplustreeindex_hpp */
@@ -9,9 +9,26 @@
 #define container_hpp
 
 #include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <string>
 #include <stdint.h>
+#include <stdlib.h>
 #include "assertlevels.hpp"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CONTAINER_VIRTUAL_MEMORY
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+// anonymous files allow copy-on-write snapshots of mapped containers
+#ifdef MFD_CLOEXEC
+#define CONTAINER_SHARED_MEMORY
+#endif
+#endif
+
 namespace bal {
     
     typedef uint32_t container_offset_t;
@@ -20,6 +37,28 @@ namespace bal {
     static constexpr container_size_t CONTAINER_SIZE_MAX = UINT32_MAX - 1;
     static constexpr container_size_t CONTAINER_END = UINT32_MAX;
     
+    // memory allocation strategy for a container
+    //   caHeap - malloc/realloc; data_ may move when the container grows
+    //   caVirtual - the address range for the maximal size is reserved at once, see set_allocation;
+    //     physical pages are committed by the system on first use; data_ never moves,
+    //     growing beyond the maximal size throws std::length_error
+    //   caVirtualHugePages - same as caVirtual, additionally requests huge pages:
+    //     MAP_HUGETLB for the initially requested size if enough are preallocated
+    //     and the rest of the range can follow it, transparent huge pages where supported otherwise
+    // where the platform does not allow the reservation, virtual strategies fall back to caHeap
+    enum container_allocation_t { caHeap, caVirtual, caVirtualHugePages };
+    
+    // size of the huge pages requested with MAP_HUGETLB, the default one on most systems
+    static constexpr size_t CONTAINER_HUGE_PAGE_SIZE = 1 << 21;
+    
+    // SNAPSHOTS
+    // share() moves the content of a mapped container into an anonymous file once
+    // and maps the file privately at the same address; snapshot() maps the same file
+    // privately into another container; all of them share the pages until those are written
+    // a snapshot has the content as of the last share(), later changes are not visible to it
+    // a snapshot is a copy where the platform does not support anonymous files
+    // or the container is not mapped
+    
     template<typename T>
     class Container {
     public:
@@ -37,9 +76,201 @@ namespace bal {
     private:
         // size of the allocated memory as a number of items of type T
         container_size_t allocated_size_ = 0;
+        // requested allocation strategy and maximal number of items for virtual ones
+        container_allocation_t allocation_ = caHeap;
+        container_size_t allocation_max_size_ = CONTAINER_SIZE_MAX;
+        // true if data_ is a mapped address range of allocated_size_ items
+        bool b_mapped_ = false;
+        // true if the range maps a shared file rather than anonymous memory
+        bool b_file_mapped_ = false;
+        // items below this size may have been written since the physical pages were last released
+        container_size_t committed_size_ = 0;
+        // anonymous file with the content shared with snapshots, -1 if not shared
+        int shared_fd_ = -1;
+        // size of the shared file as a number of items
+        container_size_t shared_size_ = 0;
+        // number of items filled with data when the file was shared, those of snapshots
+        container_size_t shared_items_ = 0;
         
     private:
+#ifdef CONTAINER_VIRTUAL_MEMORY
+        inline size_t mapped_memory_size_() const {
+            return (size_t)allocated_size_ * sizeof(T);
+        };
+        
+        inline void* map_anonymous_(void* const p_address, const size_t memory_size) const {
+            void* const p_data = mmap(p_address, memory_size, PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (p_data != MAP_FAILED && allocation_ == caVirtualHugePages) {
+                madvise(p_data, memory_size, MADV_HUGEPAGE);
+            };
+#endif
+            return p_data;
+        };
+        
+        // reserves the address range for the maximal size, throws std::bad_alloc if not possible
+        inline void map_(const container_size_t size) {
+            _assert_level_1(data_ == nullptr && size <= allocation_max_size_);
+            void* p_data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+            if (allocation_ == caVirtualHugePages) {
+                // succeeds only if the system has enough preallocated huge pages for the requested size
+                // no MAP_NORESERVE, otherwise running out of huge pages is only detected on access
+                const size_t memory_size = ((size_t)size * sizeof(T) + CONTAINER_HUGE_PAGE_SIZE - 1) / CONTAINER_HUGE_PAGE_SIZE * CONTAINER_HUGE_PAGE_SIZE;
+                if (memory_size <= (size_t)allocation_max_size_ * sizeof(T)) {
+                    p_data = mmap(nullptr, memory_size, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                };
+                if (p_data != MAP_FAILED) {
+                    data_ = (T*)p_data;
+                    allocated_size_ = (container_size_t)(memory_size / sizeof(T));
+                    // the rest of the range has regular pages, it must follow the huge ones
+                    if (!extend_(allocation_max_size_)) {
+                        munmap(p_data, memory_size);
+                        data_ = nullptr;
+                        p_data = MAP_FAILED;
+                    };
+                };
+            };
+#endif
+            if (p_data == MAP_FAILED) {
+                allocated_size_ = allocation_max_size_;
+                p_data = map_anonymous_(nullptr, mapped_memory_size_());
+                if (p_data == MAP_FAILED) {
+                    allocated_size_ = 0;
+                    throw std::bad_alloc();
+                };
+                data_ = (T*)p_data;
+            };
+            b_mapped_ = true;
+            b_file_mapped_ = false;
+            committed_size_ = 0;
+        };
+        
+        // reserves the address range following the mapped one, returns false if it is taken
+        inline bool extend_(const container_size_t size) {
+            if (size <= allocated_size_) {
+                return true;
+            };
+            uint8_t* const p_end = (uint8_t*)data_ + mapped_memory_size_();
+            const size_t memory_size = (size_t)size * sizeof(T) - mapped_memory_size_();
+            void* const p_data = map_anonymous_(p_end, memory_size);
+            if (p_data == MAP_FAILED) {
+                return false;
+            } else if (p_data != p_end) {
+                munmap(p_data, memory_size);
+                return false;
+            };
+            allocated_size_ = size;
+            return true;
+        };
+        
+        inline void unmap_() {
+            _assert_level_1(b_mapped_);
+            munmap(data_, mapped_memory_size_());
+            data_ = nullptr;
+            b_mapped_ = false;
+            b_file_mapped_ = false;
+            allocated_size_ = 0;
+            committed_size_ = 0;
+            unshare_();
+        };
+        
+        inline void unshare_() {
+            if (shared_fd_ != -1) {
+                close(shared_fd_);
+                shared_fd_ = -1;
+            };
+        };
+        
+#ifdef CONTAINER_SHARED_MEMORY
+        // writes the content to a new anonymous file then maps it privately in place of the range
+        inline bool share_() {
+            _assert_level_1(b_mapped_);
+            const int fd = memfd_create("bal_container", MFD_CLOEXEC);
+            if (fd == -1) {
+                return false;
+            };
+            bool result = ftruncate(fd, mapped_memory_size_()) == 0;
+            const uint8_t* const p_data = (const uint8_t*)data_;
+            const size_t data_size = (size_t)size_ * sizeof(T);
+            size_t written_size = 0;
+            while (result && written_size < data_size) {
+                const ssize_t size = pwrite(fd, p_data + written_size, data_size - written_size, written_size);
+                result = size > 0;
+                written_size += result ? size : 0;
+            };
+            // the content is the same, so is the address
+            result = result && mmap(data_, mapped_memory_size_(), PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE, fd, 0) != MAP_FAILED;
+            if (result) {
+                unshare_();
+                shared_fd_ = fd;
+                shared_size_ = allocated_size_;
+                shared_items_ = size_;
+                b_file_mapped_ = true;
+            } else {
+                close(fd);
+            };
+            return result;
+        };
+        
+        // maps the file shared by the other container privately
+        inline bool map_shared_(const Container& other) {
+            _assert_level_1(data_ == nullptr && other.shared_fd_ != -1);
+            allocation_ = other.allocation_;
+            allocation_max_size_ = other.allocation_max_size_;
+            allocated_size_ = other.shared_size_;
+            void* const p_data = mmap(nullptr, mapped_memory_size_(), PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE | MAP_NORESERVE, other.shared_fd_, 0);
+            if (p_data == MAP_FAILED) {
+                allocated_size_ = 0;
+                return false;
+            };
+            data_ = (T*)p_data;
+            b_mapped_ = true;
+            b_file_mapped_ = true;
+            committed_size_ = other.shared_items_;
+            return true;
+        };
+#endif
+        
+        // returns physical pages beyond the first size items to the system
+        // the address range remains reserved
+        inline void release_(const container_size_t size) {
+            _assert_level_1(b_mapped_);
+            const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+            const size_t offset = ((size_t)size * sizeof(T) + page_size - 1) / page_size * page_size;
+            const size_t end = std::min(((size_t)committed_size_ * sizeof(T) + page_size - 1) / page_size * page_size,
+                                        mapped_memory_size_());
+            if (offset < end) {
+                madvise((uint8_t*)data_ + offset, end - offset, MADV_DONTNEED);
+            };
+            committed_size_ = size;
+        };
+#endif
+        
         inline void resize_(const container_size_t size) {
+#ifdef CONTAINER_VIRTUAL_MEMORY
+            if (b_mapped_) {
+                if (size == 0) {
+                    unmap_();
+                    size_ = 0;
+                } else if (size > allocated_size_) {
+                    // data_ must not move, the reserved range is all there is
+                    throw std::length_error(std::string("container size ").append(std::to_string(size)).append(" exceeds the maximal one ").append(std::to_string(allocated_size_)));
+                } else {
+                    // physical memory beyond the requested size is released
+                    release_(std::max(size, size_));
+                };
+                return;
+            } else if (allocation_ != caHeap && data_ == nullptr && size != 0) {
+                map_(size);
+                size_ = 0;
+                return;
+            };
+#endif
             if (allocated_size_ != size) {
                 if (data_ != nullptr) {
                     if (size == 0) {
@@ -68,6 +299,7 @@ namespace bal {
             if (size_ != size) {
                 resize_(size);
                 size_ = size;
+                committed_size_ = std::max(committed_size_, size);
             };
         };
         
@@ -102,12 +334,78 @@ namespace bal {
             data_ = other.data_;
             allocated_size_ = other.allocated_size_;
             size_ = other.size_;
+            allocation_ = other.allocation_;
+            allocation_max_size_ = other.allocation_max_size_;
+            b_mapped_ = other.b_mapped_;
+            b_file_mapped_ = other.b_file_mapped_;
+            committed_size_ = other.committed_size_;
+            shared_fd_ = other.shared_fd_;
+            shared_size_ = other.shared_size_;
+            shared_items_ = other.shared_items_;
             other.data_ = nullptr;
             other.allocated_size_ = 0;
             other.size_ = 0;
+            other.b_mapped_ = false;
+            other.b_file_mapped_ = false;
+            other.committed_size_ = 0;
+            other.shared_fd_ = -1;
             return *this;
         };
         
+        // changes memory allocation strategy, keeps the data
+        // max_size is the number of items the address range is reserved for with virtual strategies
+        inline void set_allocation(const container_allocation_t allocation,
+                                   const container_size_t max_size = CONTAINER_SIZE_MAX) {
+            _assert_level_0(max_size > 0 && max_size >= size_);
+            if (allocation != allocation_ || max_size != allocation_max_size_) {
+                Container other(std::move(*this));
+                allocation_ = allocation;
+                allocation_max_size_ = max_size;
+                if (other.size_ > 0) {
+                    resize(other.size_);
+                    std::copy(other.data_, other.data_ + other.size_, data_);
+                };
+            };
+        };
+        
+        // true if data_ never moves while the container grows, so pointers taken before an append remain valid
+        inline bool is_address_stable() const {
+            return b_mapped_;
+        };
+        
+        // makes the current content the one of subsequent snapshots, see SNAPSHOTS
+        // returns false if snapshots are going to be copies
+        inline bool share() {
+#ifdef CONTAINER_SHARED_MEMORY
+            return b_mapped_ && share_();
+#else
+            return false;
+#endif
+        };
+        
+        inline bool is_shared() const {
+            return shared_fd_ != -1;
+        };
+        
+        // number of items of snapshots, the size as of the last share()
+        inline container_size_t shared_size() const {
+            return is_shared() ? shared_items_ : size_;
+        };
+        
+        // replaces the content with the one shared by the other container or a copy of it
+        inline void snapshot(const Container& other) {
+            resize_(0);
+#ifdef CONTAINER_SHARED_MEMORY
+            if (other.is_shared() && map_shared_(other)) {
+                size_ = other.shared_items_;
+                return;
+            };
+#endif
+            allocation_ = other.allocation_;
+            allocation_max_size_ = other.allocation_max_size_;
+            this->operator=(other);
+        };
+        
         // number of bytes used to store actual data; used not allocated
         inline size_t memory_size() const { return size_ * sizeof(T); };
         
@@ -119,9 +417,11 @@ namespace bal {
         // size is number of words to reserve
         inline void reserve(const container_size_t reserve_size) {
             if (allocated_size_ < size_ + reserve_size) {
-                // grow 1.5 times each time
-                resize_(size_ + reserve_size + (allocated_size_ >> 1));
+                // grow 1.5 times each time, within the maximal size of virtual strategies
+                const container_size_t size = size_ + reserve_size;
+                resize_(std::max(size, std::min(size + (allocated_size_ >> 1), allocation_max_size_)));
             };
+            committed_size_ = std::max(committed_size_, size_ + reserve_size);
         };
         
         // append the list with
@@ -8,6 +8,8 @@
 #ifndef containerindex_hpp
 #define containerindex_hpp
 
+#include <vector>
+#include <algorithm>
 #include "container.hpp"
 #include "assertlevels.hpp"
 
@@ -24,6 +26,73 @@ namespace bal {
     };
     
 #define __insertion_point_t_init(value) value.version_stamp = CONTAINER_END;
+
+    // describes how container items move when the container is compacted
+    // i.e. removed items are dropped and the remaining ones are moved towards the beginning
+    // the sequence of the remaining items is preserved
+    // lists indexed items in order; items below base_ which are not listed stay where they are,
+    // other items which are not listed are removed
+    class ContainerOffsetsMap {
+    private:
+        std::vector<container_offset_t> offsets_;
+        std::vector<container_offset_t> new_offsets_;
+        container_size_t base_ = 0;
+        container_size_t new_size_ = 0;
+        
+        inline size_t index_of(const container_offset_t offset) const {
+            return std::lower_bound(offsets_.begin(), offsets_.end(), offset) - offsets_.begin();
+        };
+        
+    public:
+        inline void reset(const container_size_t base) {
+            offsets_.clear();
+            new_offsets_.clear();
+            base_ = base;
+            new_size_ = base;
+        };
+        
+        // items are appended in order
+        inline void append(const container_offset_t offset, const container_offset_t new_offset) {
+            _assert_level_1(offsets_.empty() || offsets_.back() < offset);
+            _assert_level_1(offset >= base_ || new_offset == offset);
+            offsets_.push_back(offset);
+            new_offsets_.push_back(new_offset);
+        };
+        
+        inline size_t size() const { return offsets_.size(); };
+        inline container_offset_t offset(const size_t index) const { return offsets_[index]; };
+        inline container_offset_t new_offset(const size_t index) const { return new_offsets_[index]; };
+        
+        inline container_size_t base() const { return base_; };
+        inline container_size_t new_size() const { return new_size_; };
+        inline void set_new_size(const container_size_t value) { new_size_ = value; };
+        
+        // new offset of the item; CONTAINER_END if the item is removed
+        inline container_offset_t operator()(const container_offset_t offset) const {
+            if (offset == CONTAINER_END) {
+                return CONTAINER_END;
+            };
+            const size_t index = index_of(offset);
+            if (index < offsets_.size() && offsets_[index] == offset) {
+                return new_offsets_[index];
+            } else {
+                return offset < base_ ? offset : CONTAINER_END;
+            };
+        };
+        
+        // new offset of the first remaining item at or after the offset, or the new size
+        inline container_offset_t lower_bound(const container_offset_t offset) const {
+            if (offset < base_) {
+                return offset;
+            };
+            for (size_t index = index_of(offset); index < offsets_.size(); index++) {
+                if (new_offsets_[index] != CONTAINER_END) {
+                    return new_offsets_[index];
+                };
+            };
+            return new_size_;
+        };
+    };
     
     // ContainerIndex implements a set of index instances
     // each index instance is a sequence of index items
@@ -51,12 +120,50 @@ namespace bal {
         Container<container_offset_t> instances_;
         
     private:
+        // TRANSACTIONS
+        // transactions nest, each nested one is a savepoint within the enclosing one;
+        // the innermost one defines the bound of immutable items and is mirrored by the below
         container_size_t transaction_size_ = CONTAINER_END;
-        container_size_t transaction_container_size_ = CONTAINER_END;
         container_size_t transaction_instances_size_ = CONTAINER_END;
         container_size_t version_stamp_ = 0;
         
+        struct transaction_t {
+            container_size_t size;
+            container_size_t container_size;
+            container_size_t instances_size;
+            container_size_t log_size;
+            container_size_t instances_log_size;
+        };
+        std::vector<transaction_t> transactions_;
+        
+        // UNDO LOG
+        // previous values of index words and instances changed within the transaction bound
+        // each is logged every time it changes; rollback restores them in reverse order
+        // entries of a committed nested transaction are kept for the enclosing one
+        template<typename T>
+        struct transaction_log_item_t {
+            container_offset_t offset;
+            T value;
+        };
+        Container<transaction_log_item_t<INDEX_DATA_T>> transaction_log_;
+        Container<transaction_log_item_t<container_offset_t>> transaction_instances_log_;
+        
+        inline void transaction_pop() {
+            transactions_.pop_back();
+            if (transactions_.empty()) {
+                transaction_size_ = CONTAINER_END;
+                transaction_instances_size_ = CONTAINER_END;
+                transaction_log_.size_ = 0;
+                transaction_instances_log_.size_ = 0;
+            } else {
+                transaction_size_ = transactions_.back().size;
+                transaction_instances_size_ = transactions_.back().instances_size;
+            };
+        };
+        
     protected:
+        // truncates the index; called once words logged within the transaction are restored
+        // descendants not logging all their changes must rebuild themselves
         virtual void rollback(const container_size_t size,
                               const container_size_t instances_size,
                               const container_size_t container_size) {
@@ -66,6 +173,28 @@ namespace bal {
             instances_.size_ = instances_size;
         };
         
+        // items below this offset must not move while in the outermost transaction
+        inline container_size_t transaction_outermost_immutable_size() const {
+            return transactions_.empty() ? 0 : transactions_.front().size;
+        };
+        
+        // changes a word of the index; it is logged if within the transaction bound
+        inline void transaction_set(const container_offset_t offset, const INDEX_DATA_T value) {
+            if (transaction_offset_is_immutable(offset) && this->data_[offset] != value) {
+                transaction_log_.append({offset, this->data_[offset]}, 1);
+            };
+            this->data_[offset] = value;
+        };
+        
+        // changes the root of an instance; it is logged if within the transaction bound
+        inline void transaction_set_instance(const container_offset_t instance_offset, const container_offset_t value) {
+            if (transaction_size_ != CONTAINER_END && instance_offset < transaction_instances_size_ &&
+                instances_.data_[instance_offset] != value) {
+                transaction_instances_log_.append({instance_offset, instances_.data_[instance_offset]}, 1);
+            };
+            instances_.data_[instance_offset] = value;
+        };
+        
         inline void insertion_point_init(insertion_point_t& insertion_point) const {
             insertion_point.version_stamp = version_stamp_;
         };
@@ -85,7 +214,8 @@ namespace bal {
         };
         
         virtual size_t memory_size() const {
-            return Container<INDEX_DATA_T>::memory_size() + instances_.memory_size();
+            return Container<INDEX_DATA_T>::memory_size() + instances_.memory_size() +
+                transaction_log_.memory_size() + transaction_instances_log_.memory_size();
         };
         
         virtual void reset(const container_size_t instances_size, const container_size_t index_size) {
@@ -95,35 +225,73 @@ namespace bal {
             Container<INDEX_DATA_T>::reset(index_size);
         };
         
-        inline void transaction_begin() {
+        // the index shares its items with snapshots copy-on-write if possible, see SNAPSHOTS in container.hpp
+        inline bool share() {
             _assert_level_1(!transaction_is_in());
+            return Container<INDEX_DATA_T>::share();
+        };
+        
+        // makes the index a snapshot of the other one; instances are copied
+        // only for an index containing the data itself; descendants having other data must redefine it
+        inline void snapshot(const ContainerIndex& other) {
+            _assert_level_1(!transaction_is_in() && !other.transaction_is_in());
+            Container<INDEX_DATA_T>::snapshot(other);
+            instances_ = other.instances_;
+            insertion_point_invalidate();
+        };
+        
+        // begins a transaction or a savepoint within the current one
+        inline void transaction_begin() {
+            transactions_.push_back({this->size_, p_container_->size_, instances_.size_,
+                                     transaction_log_.size_, transaction_instances_log_.size_});
             transaction_size_ = this->size_;
-            transaction_container_size_ = p_container_->size_;
             transaction_instances_size_ = instances_.size_;
         };
         
+        // keeps the changes; those of a savepoint can still be rolled back with the enclosing transaction
         inline void transaction_commit() {
             _assert_level_1(transaction_is_in());
-            transaction_size_ = CONTAINER_END;
-            transaction_container_size_ = CONTAINER_END;
-            transaction_instances_size_ = CONTAINER_END;
+            transaction_pop();
         };
         
+        // reverts the changes made since the innermost transaction began
+        // the cost is that of the changes only for descendants logging all of them, see is_transaction_logged;
+        // others rebuild the whole index, also when rolling back a savepoint
         inline void transaction_rollback() {
             _assert_level_1(transaction_is_in() && this->size_ >= transaction_size_);
-            rollback(transaction_size_, transaction_instances_size_, transaction_container_size_);
-            transaction_size_ = CONTAINER_END;
-            transaction_container_size_ = CONTAINER_END;
-            transaction_instances_size_ = CONTAINER_END;
+            const transaction_t transaction = transactions_.back();
+            for (auto i = transaction_log_.size_; i > transaction.log_size; i--) {
+                const transaction_log_item_t<INDEX_DATA_T>& item = transaction_log_.data_[i - 1];
+                this->data_[item.offset] = item.value;
+            };
+            for (auto i = transaction_instances_log_.size_; i > transaction.instances_log_size; i--) {
+                const transaction_log_item_t<container_offset_t>& item = transaction_instances_log_.data_[i - 1];
+                instances_.data_[item.offset] = item.value;
+            };
+            transaction_log_.size_ = transaction.log_size;
+            transaction_instances_log_.size_ = transaction.instances_log_size;
+            // the rollback may rebuild the index, those changes are not logged
+            transaction_pop();
+            rollback(transaction.size, transaction.instances_size, transaction.container_size);
         };
         
         inline bool transaction_is_in() const {
             return transaction_size_ != CONTAINER_END;
         };
         
+        // number of open transactions including savepoints
+        inline size_t transaction_depth() const {
+            return transactions_.size();
+        };
+        
         inline bool transaction_offset_is_immutable(const container_offset_t offset) const {
             return transaction_size_ != CONTAINER_END && offset < transaction_size_;
         };
+        
+        // items below this offset must not move
+        inline container_size_t transaction_immutable_size() const {
+            return transaction_size_ == CONTAINER_END ? 0 : transaction_size_;
+        };
     };
     
     // iterates over the whole index
@@ -131,6 +299,7 @@ namespace bal {
     // returns data pointers for the target container
     // note that these pointers may be invalidated during
     // subsequent changes made to the container
+    // unless the container is_address_stable()
     
     template<class INDEX_T>
     class ContainerIndexIterator {
@@ -146,17 +315,19 @@ namespace bal {
         
     private:
         // find the next instance with at least one item
+        // an instance may be empty even if it has a root, e.g. after its items are removed
         inline void load_instance() {
             // move to the next instance which has items
-            while (instance_offset_ < index_.instances_.size_ &&
-                   index_.instances_.data_[instance_offset_] == CONTAINER_END) {
+            container_offset_ = CONTAINER_END;
+            while (instance_offset_ < index_.instances_.size_) {
+                if (index_.instances_.data_[instance_offset_] != CONTAINER_END) {
+                    container_offset_ = instance_iterator_.first(instance_offset_);
+                    if (container_offset_ != CONTAINER_END) {
+                        break;
+                    };
+                };
                 instance_offset_++;
             };
-            if (instance_offset_ < index_.instances_.size_) {
-                container_offset_ = instance_iterator_.first(instance_offset_);
-            } else {
-                container_offset_ = CONTAINER_END;
-            };
         };
         
         inline void next_item() {
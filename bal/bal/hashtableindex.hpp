@@ -0,0 +1,425 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef hashtableindex_hpp
+#define hashtableindex_hpp
+
+#include "containerindex.hpp"
+
+namespace bal {
+    
+    // "hti" refers to hash table index
+    // the index contains the data itself, i.e. index offsets are container offsets
+    // each index item is 3 words placed in front of the data item:
+    //   chain - next item with the same hash value
+    //   next, prev - doubly linked list of items of the same instance, unordered
+    // the hash table uses open addressing; each slot keeps a hash value and
+    // the container offset of the first item of the chain for that hash value
+    // a slot is never reused for a different hash value until the table is rebuilt
+    
+#define _hti_item(p_data, offset) ((p_data) + (offset))
+    
+#define _hti_item_chain_offset(p_item) (*(p_item))
+#define _hti_item_next_offset(p_item) (*((p_item) + 1))
+#define _hti_item_prev_offset(p_item) (*((p_item) + 2))
+#define _hti_item_container_item(p_item) ((p_item) + 3)
+    
+#define _hti_chain_offset(p_data, offset) _hti_item_chain_offset(_hti_item(p_data, offset))
+#define _hti_next_offset(p_data, offset) _hti_item_next_offset(_hti_item(p_data, offset))
+#define _hti_prev_offset(p_data, offset) _hti_item_prev_offset(_hti_item(p_data, offset))
+    
+    // marks items removed from the index; container offsets never reach this value
+    static constexpr container_offset_t HTI_UNLINKED = CONTAINER_END - 1;
+    
+    // hash value reserved for empty slots
+    static constexpr uint32_t HTI_HASH_EMPTY = 0;
+    
+    typedef enum {htipkNew, htipkCurrent} hash_table_insertion_point_kind_t;
+    
+    // container_offset is the matching item for htipkCurrent, CONTAINER_END for htipkNew
+    // hash and instance are kept since the item may be indexed before its data is updated
+    struct hash_table_insertion_point_t: container_index_insertion_point_t {
+        hash_table_insertion_point_kind_t kind;
+        uint32_t hash;
+        container_offset_t instance;
+    };
+    
+    typedef struct {
+        uint32_t hash;
+        container_offset_t offset;
+    } hash_table_slot_t;
+    
+    // iterates over all items for particular instance, in no particular order
+    // used as the default iterator for HashTablesIndex
+    template<typename, typename>
+    class UnorderedListsIndexInstanceOffsetIterator;
+    
+    // a set of unordered doubly linked lists, one per instance
+    template<typename CONTAINER_DATA_T, typename INSERTION_POINT_T>
+    class UnorderedListsIndex: public ContainerIndex<container_offset_t, CONTAINER_DATA_T, UnorderedListsIndexInstanceOffsetIterator<CONTAINER_DATA_T, INSERTION_POINT_T>, INSERTION_POINT_T> {
+    private:
+        using base_t = ContainerIndex<container_offset_t, CONTAINER_DATA_T, UnorderedListsIndexInstanceOffsetIterator<CONTAINER_DATA_T, INSERTION_POINT_T>, INSERTION_POINT_T>;
+        
+        template<typename, typename>
+        friend class UnorderedListsIndexInstanceOffsetIterator;
+        
+    public:
+        UnorderedListsIndex(const Container<CONTAINER_DATA_T>* const p_container): base_t(p_container) {};
+        
+        using instance_iterator_t = UnorderedListsIndexInstanceOffsetIterator<CONTAINER_DATA_T, INSERTION_POINT_T>;
+    };
+    
+    template<typename CONTAINER_DATA_T, typename INSERTION_POINT_T>
+    class UnorderedListsIndexInstanceOffsetIterator {
+    public:
+        using index_t = UnorderedListsIndex<CONTAINER_DATA_T, INSERTION_POINT_T>;
+        
+    protected:
+        const index_t& index_;
+        container_offset_t item_offset_ = CONTAINER_END;
+        
+    public:
+        UnorderedListsIndexInstanceOffsetIterator(const index_t& index): index_(index) {};
+        
+        // positions at the first list item for the given instance
+        // returns offset of the corresponding container data element or CONTAINER_END
+        inline container_offset_t first(const container_offset_t instance_offset) {
+            item_offset_ = instance_offset >= index_.instances_.size_ ? CONTAINER_END : index_.instances_.data_[instance_offset];
+            return item_offset_;
+        };
+        
+        // moves to the next list item for the stored instance
+        // returns offset of the corresponding container data element or CONTAINER_END
+        inline container_offset_t next() {
+            if (item_offset_ != CONTAINER_END) {
+                item_offset_ = _hti_next_offset(index_.data_, item_offset_);
+            };
+            return item_offset_;
+        };
+    };
+    
+    template<typename CONTAINER_DATA_T, bool contains_data_itself,
+             typename Container<CONTAINER_DATA_T>::comparator_p comparator,
+             uint32_t (*hasher)(const CONTAINER_DATA_T* const value),
+             container_offset_t (*instance_determiner)(const CONTAINER_DATA_T* const value)>
+    class HashTablesIndex: public UnorderedListsIndex<CONTAINER_DATA_T, hash_table_insertion_point_t> {
+        static_assert(contains_data_itself, "only implemented for the index containing the data itself");
+        
+    public:
+        using base_t = UnorderedListsIndex<CONTAINER_DATA_T, hash_table_insertion_point_t>;
+        using insertion_point_t = hash_table_insertion_point_t;
+        
+        // items of an instance are not ordered
+        static constexpr bool is_ordered = false;
+        // slots and links are not logged, rollback rebuilds the index, that of a savepoint as well;
+        // only unlinking of items is logged so that the same items are indexed again
+        // AvlTreesIndex is the one to use for rolling back savepoints often
+        static constexpr bool is_transaction_logged = false;
+        // slots are shared by all instances, instances are built one by one
+        static constexpr bool is_build_concurrent = false;
+        
+    private:
+        // number of slots is a power of 2
+        Container<hash_table_slot_t> slots_;
+        // number of slots with a hash value assigned
+        container_size_t slots_used_ = 0;
+        
+    private:
+        inline static uint32_t hash(const CONTAINER_DATA_T* const p_object) {
+            const uint32_t result = hasher(p_object);
+            return result == HTI_HASH_EMPTY ? 1 : result;
+        };
+        
+        // returns the slot for the hash value or an empty slot where it can be placed
+        inline container_offset_t probe(const uint32_t hash_value) const {
+            _assert_level_1(slots_.size_ > 0);
+            const container_size_t mask = slots_.size_ - 1;
+            container_offset_t slot = hash_value & mask;
+            while (slots_.data_[slot].hash != HTI_HASH_EMPTY && slots_.data_[slot].hash != hash_value) {
+                slot = (slot + 1) & mask;
+            };
+            return slot;
+        };
+        
+        // slots are rebuilt from the chains; slots without items are dropped
+        inline void rehash(const container_size_t slots_size) {
+            Container<hash_table_slot_t> slots(std::move(slots_));
+            slots_.reset(slots_size);
+            slots_.append({HTI_HASH_EMPTY, CONTAINER_END}, slots_size);
+            slots_used_ = 0;
+            for (auto i = 0; i < slots.size_; i++) {
+                if (slots.data_[i].hash != HTI_HASH_EMPTY && slots.data_[i].offset != CONTAINER_END) {
+                    const container_offset_t slot = probe(slots.data_[i].hash);
+                    slots_.data_[slot] = slots.data_[i];
+                    slots_used_++;
+                };
+            };
+        };
+        
+        inline void reset_slots(const container_size_t items_size) {
+            container_size_t slots_size = 16;
+            while (slots_size < items_size * 2) {
+                slots_size <<= 1;
+            };
+            slots_.reset(slots_size);
+            slots_.append({HTI_HASH_EMPTY, CONTAINER_END}, slots_size);
+            slots_used_ = 0;
+        };
+        
+        // replaces the offset with new_offset in the chain starting from the slot
+        inline void _update_chain(const container_offset_t slot, const container_offset_t offset, const container_offset_t new_offset) {
+            container_offset_t* p_offset = &(slots_.data_[slot].offset);
+            while (*p_offset != offset) {
+                _assert_level_1(*p_offset != CONTAINER_END);
+                p_offset = &_hti_chain_offset(this->data_, *p_offset);
+            };
+            *p_offset = new_offset;
+        };
+        
+        // replaces the offset with new_offset in the instance list
+        inline void _update_list(const container_offset_t offset, const container_offset_t new_offset) {
+            const container_offset_t* const p_item = _hti_item(this->data_, offset);
+            const container_offset_t prev_offset = _hti_item_prev_offset(p_item);
+            const container_offset_t next_offset = _hti_item_next_offset(p_item);
+            if (prev_offset != CONTAINER_END) {
+                _hti_next_offset(this->data_, prev_offset) = new_offset;
+            } else {
+                const container_offset_t instance_offset = instance_determiner(_hti_item_container_item(p_item));
+                _assert_level_1(instance_offset < this->instances_.size_);
+                _assert_level_1(this->instances_.data_[instance_offset] == offset);
+                this->instances_.data_[instance_offset] = new_offset;
+            };
+            if (next_offset != CONTAINER_END) {
+                _hti_prev_offset(this->data_, next_offset) = new_offset;
+            };
+        };
+        
+        // excludes the item from the index; the item data must be unchanged since it was indexed
+        inline void _remove(const container_offset_t offset) {
+            _assert_level_0(offset < this->size_);
+            container_offset_t* const p_item = _hti_item(this->data_, offset);
+            _assert_level_1(_hti_item_next_offset(p_item) != HTI_UNLINKED);
+            
+            const container_offset_t slot = probe(hash(_hti_item_container_item(p_item)));
+            _update_chain(slot, offset, _hti_item_chain_offset(p_item));
+            
+            const container_offset_t prev_offset = _hti_item_prev_offset(p_item);
+            const container_offset_t next_offset = _hti_item_next_offset(p_item);
+            if (prev_offset != CONTAINER_END) {
+                _hti_next_offset(this->data_, prev_offset) = next_offset;
+            } else {
+                const container_offset_t instance_offset = instance_determiner(_hti_item_container_item(p_item));
+                _assert_level_1(this->instances_.data_[instance_offset] == offset);
+                this->instances_.data_[instance_offset] = next_offset;
+            };
+            if (next_offset != CONTAINER_END) {
+                _hti_prev_offset(this->data_, next_offset) = prev_offset;
+            };
+            
+            _hti_item_chain_offset(p_item) = HTI_UNLINKED;
+            this->transaction_set(offset + 1, HTI_UNLINKED);
+            _hti_item_prev_offset(p_item) = HTI_UNLINKED;
+        };
+        
+        inline bool _is_linked(const container_offset_t offset) const {
+            return offset < this->size_ && _hti_next_offset(this->data_, offset) != HTI_UNLINKED;
+        };
+        
+    protected:
+        void rollback(const container_size_t size,
+                      const container_size_t instances_size,
+                      const container_size_t container_size) override {
+            // items beyond size may be referred by slots; the table is rebuilt by the descendant
+            _assert_level_0(size == 0);
+            base_t::rollback(size, instances_size, container_size);
+            reset_slots(slots_used_);
+        };
+        
+        // insert the provided index element (offset) as specified by the insertion point
+        // htipkCurrent replaces the matching item which is excluded from the index
+        inline void _update(const container_offset_t offset, const insertion_point_t& insertion_point) {
+            _assert_level_1(this->insertion_point_is_valid(insertion_point));
+            this->insertion_point_invalidate();
+            
+            container_offset_t* const p_item = _hti_item(this->data_, offset);
+            
+            if (insertion_point.kind == htipkCurrent) {
+                _assert_level_0(insertion_point.container_offset != CONTAINER_END);
+                _assert_level_0(insertion_point.container_offset != offset);
+                const container_offset_t original_offset = insertion_point.container_offset;
+                const container_offset_t* const p_original_item = _hti_item(this->data_, original_offset);
+                _update_chain(probe(insertion_point.hash), original_offset, offset);
+                _hti_item_chain_offset(p_item) = _hti_item_chain_offset(p_original_item);
+                _update_list(original_offset, offset);
+                _hti_item_next_offset(p_item) = _hti_item_next_offset(p_original_item);
+                _hti_item_prev_offset(p_item) = _hti_item_prev_offset(p_original_item);
+                _hti_chain_offset(this->data_, original_offset) = HTI_UNLINKED;
+                this->transaction_set(original_offset + 1, HTI_UNLINKED);
+                _hti_prev_offset(this->data_, original_offset) = HTI_UNLINKED;
+            } else {
+                _assert_level_0(insertion_point.container_offset == CONTAINER_END);
+                
+                container_offset_t slot = probe(insertion_point.hash);
+                if (slots_.data_[slot].hash == HTI_HASH_EMPTY) {
+                    // keep the load factor below 1/2
+                    if ((slots_used_ + 1) << 1 > slots_.size_) {
+                        rehash(slots_.size_ << 1);
+                        slot = probe(insertion_point.hash);
+                    };
+                    slots_.data_[slot].hash = insertion_point.hash;
+                    slots_used_++;
+                };
+                _hti_item_chain_offset(p_item) = slots_.data_[slot].offset;
+                slots_.data_[slot].offset = offset;
+                
+                const container_offset_t instance_offset = insertion_point.instance;
+                if (instance_offset >= this->instances_.size_) {
+                    this->instances_.append(CONTAINER_END, instance_offset - this->instances_.size_ + 1);
+                };
+                container_offset_t* const p_instance = this->instances_.data_ + instance_offset;
+                _hti_item_prev_offset(p_item) = CONTAINER_END;
+                _hti_item_next_offset(p_item) = *p_instance;
+                if (*p_instance != CONTAINER_END) {
+                    _hti_prev_offset(this->data_, *p_instance) = offset;
+                };
+                *p_instance = offset;
+            };
+        };
+        
+    public:
+        HashTablesIndex(): base_t(this) {
+            reset_slots(0);
+        };
+        
+        size_t memory_size() const override {
+            return base_t::memory_size() + slots_.memory_size();
+        };
+        
+        // index_size is the expected container size; about 8 words per item is assumed
+        void reset(const container_size_t instances_size, const container_size_t index_size) override {
+            base_t::reset(instances_size, index_size);
+            reset_slots(index_size >> 3);
+        };
+        
+        inline void snapshot(const HashTablesIndex& other) {
+            base_t::snapshot(other);
+            slots_ = other.slots_;
+            slots_used_ = other.slots_used_;
+        };
+        
+        // updates the index entry for a given container_offset
+        // ensuring it is removed from the previous location and
+        // is located according to the provided insertion_point
+        // the item data must be unchanged since it was indexed
+        inline void update(const container_offset_t container_offset, const insertion_point_t& insertion_point) {
+            _assert_level_0(insertion_point.kind != htipkCurrent || insertion_point.container_offset != container_offset);
+            _remove(container_offset);
+            _update(container_offset, insertion_point);
+        };
+        
+        // excludes the item from the index; the item data must be unchanged since it was indexed
+        inline void remove(const container_offset_t container_offset) {
+            this->insertion_point_invalidate();
+            _remove(container_offset);
+        };
+        
+        // an insertion point referring to an item remains valid for as long as the item is indexed
+        bool insertion_point_is_valid(const insertion_point_t& insertion_point) const override {
+            bool result = base_t::insertion_point_is_valid(insertion_point);
+            if (!result && insertion_point.version_stamp != CONTAINER_END && insertion_point.kind == htipkCurrent) {
+                result = _is_linked(insertion_point.container_offset);
+            };
+            return result;
+        };
+        
+        // initialize insertion point to replace the supplied container offset
+        // insertion point is only updated if the item is indexed
+        inline void insertion_point_from_container_offset(insertion_point_t& insertion_point, const container_offset_t offset) {
+            if (insertion_point.version_stamp == CONTAINER_END ||
+                insertion_point.kind != htipkCurrent || insertion_point.container_offset != offset) {
+                if (_is_linked(offset)) {
+                    this->insertion_point_init(insertion_point);
+                    insertion_point.kind = htipkCurrent;
+                    insertion_point.hash = hash(_hti_item_container_item(_hti_item(this->data_, offset)));
+                    insertion_point.instance = instance_determiner(_hti_item_container_item(_hti_item(this->data_, offset)));
+                    insertion_point.container_offset = offset;
+                };
+            };
+        };
+        
+        // indexes all items of an empty instance at once; offsets are ordered by comparator
+        // items are inserted in container sequence so that the instance list is the same
+        // as if they were appended one by one
+        inline void build(const container_offset_t instance_offset, const container_offset_t* const offsets, const container_size_t size) {
+            std::vector<container_offset_t> sequence(offsets, offsets + size);
+            std::sort(sequence.begin(), sequence.end());
+            insertion_point_t insertion_point;
+            for (auto offset: sequence) {
+                find(_hti_item_container_item(_hti_item(this->data_, offset)), insertion_point);
+                _assert_level_1(insertion_point.container_offset == CONTAINER_END);
+                _update(offset, insertion_point);
+            };
+        };
+
+        inline bool is_indexed(const container_offset_t offset) const {
+            return _is_linked(offset);
+        };
+
+
+        // updates references between items before they are moved according to the map
+        // removed items must not be indexed
+        inline void remap(const ContainerOffsetsMap& map) {
+            this->insertion_point_invalidate();
+            for (auto i = 0; i < map.size(); i++) {
+                container_offset_t* const p_item = _hti_item(this->data_, map.offset(i));
+                if (_hti_item_next_offset(p_item) != HTI_UNLINKED) {
+                    _assert_level_1(map.new_offset(i) != CONTAINER_END);
+                    _hti_item_chain_offset(p_item) = map(_hti_item_chain_offset(p_item));
+                    _hti_item_next_offset(p_item) = map(_hti_item_next_offset(p_item));
+                    _hti_item_prev_offset(p_item) = map(_hti_item_prev_offset(p_item));
+                };
+            };
+            for (auto i = 0; i < slots_.size_; i++) {
+                slots_.data_[i].offset = map(slots_.data_[i].offset);
+            };
+            for (auto i = 0; i < this->instances_.size_; i++) {
+                this->instances_.data_[i] = map(this->instances_.data_[i]);
+            };
+        };
+
+        // make the insertion point refer to the item at the offset, once it is indexed
+        inline void insertion_point_set_current(insertion_point_t& insertion_point, const container_offset_t offset) const {
+            insertion_point.kind = htipkCurrent;
+            insertion_point.container_offset = offset;
+        };
+        
+        inline container_offset_t find(const CONTAINER_DATA_T* const p_object) const {
+            const container_offset_t slot = probe(hash(p_object));
+            container_offset_t offset = slots_.data_[slot].offset;
+            while (offset != CONTAINER_END) {
+                const container_offset_t* const p_item = _hti_item(this->data_, offset);
+                if (comparator(p_object, _hti_item_container_item(p_item)) == 0) {
+                    return offset;
+                };
+                offset = _hti_item_chain_offset(p_item);
+            };
+            return CONTAINER_END;
+        };
+        
+        // find a match for p_object
+        // insertion point is either the matching item or the hash value for a new one
+        inline void find(const CONTAINER_DATA_T* const p_object, insertion_point_t &insertion_point) const {
+            this->insertion_point_init(insertion_point);
+            insertion_point.hash = hash(p_object);
+            insertion_point.instance = instance_determiner(p_object);
+            insertion_point.container_offset = find(p_object);
+            insertion_point.kind = insertion_point.container_offset == CONTAINER_END ? htipkNew : htipkCurrent;
+        };
+    };
+};
+
+#endif /* hashtableindex_hpp */
@@ -8,6 +8,7 @@
 #ifndef linkedlistindex_hpp
 #define linkedlistindex_hpp
 
+#include <vector>
 #include "assertlevels.hpp"
 #include "containerindex.hpp"
 
@@ -19,6 +20,10 @@ namespace bal {
         container_offset_t container_offset;
     };
     
+    inline bool operator != (const list_index_item_t& lhs, const list_index_item_t& rhs) {
+        return lhs.next_offset != rhs.next_offset || lhs.container_offset != rhs.container_offset;
+    };
+    
     typedef enum {liipkRoot, liipkAfter} list_index_insertion_point_kind_t;
     
     struct list_index_insertion_point_t: container_index_insertion_point_t {
@@ -147,6 +152,11 @@ namespace bal {
         };
     };
     
+    // TRANSACTIONS
+    // links changed by appending items and by optimizing iterators unlinking them are logged
+    // within the transaction bound, see ContainerIndex; rollback links the items unlinked
+    // within the transaction again and drops those appended, the cost is proportional to the changes
+    // last items of instances are logged separately; the index may not be remapped within a transaction
     template<typename CONTAINER_DATA_T>
     class SimpleLinkedListsIndex: public LinkedListsIndex<CONTAINER_DATA_T> {
         template<typename, class FILTER_T, typename Filterable<FILTER_T>::is_included_t>
@@ -155,17 +165,55 @@ namespace bal {
         friend class SimpleLinkedListsIndexMergedFilteredOptimizingInstanceOffsetIterator;
 
     private:
+        using base_t = LinkedListsIndex<CONTAINER_DATA_T>;
+        
         Container<container_offset_t> instances_last_;
         
+        // previous last items of instances, logged within transactions
+        struct instance_last_log_item_t {
+            container_offset_t instance_offset;
+            container_offset_t value;
+        };
+        Container<instance_last_log_item_t> instances_last_log_;
+        std::vector<container_size_t> instances_last_log_sizes_;
+        
+        inline void link_next(const container_offset_t offset, const container_offset_t next_offset) {
+            this->transaction_set(offset, { next_offset, this->data_[offset].container_offset });
+        };
+        
+        inline void link_first(const container_offset_t instance_offset, const container_offset_t offset) {
+            this->transaction_set_instance(instance_offset, offset);
+        };
+        
+        inline void link_last(const container_offset_t instance_offset, const container_offset_t offset) {
+            if (!instances_last_log_sizes_.empty() && instances_last_.data_[instance_offset] != offset) {
+                instances_last_log_.append({instance_offset, instances_last_.data_[instance_offset]}, 1);
+            };
+            instances_last_.data_[instance_offset] = offset;
+        };
+        
+    protected:
+        void rollback(const container_size_t size,
+                      const container_size_t instances_size,
+                      const container_size_t container_size) override {
+            for (auto i = instances_last_log_.size_; i > instances_last_log_sizes_.back(); i--) {
+                const instance_last_log_item_t& item = instances_last_log_.data_[i - 1];
+                instances_last_.data_[item.instance_offset] = item.value;
+            };
+            instances_last_log_.size_ = instances_last_log_sizes_.back();
+            instances_last_.size_ = instances_size;
+            base_t::rollback(size, instances_size, container_size);
+        };
+        
     public:
         SimpleLinkedListsIndex(const Container<CONTAINER_DATA_T>* const p_container): LinkedListsIndex<CONTAINER_DATA_T>(p_container) {};
         
         size_t memory_size() const override {
-            return LinkedListsIndex<CONTAINER_DATA_T>::memory_size() + instances_last_.memory_size();
+            return base_t::memory_size() + instances_last_.memory_size() + instances_last_log_.memory_size();
         };
         
         void reset(const container_size_t instances_size, const container_size_t index_size) override {
-            LinkedListsIndex<CONTAINER_DATA_T>::reset(instances_size, index_size);
+            base_t::reset(instances_size, index_size);
             instances_last_.reset(instances_size);
             instances_last_.append(CONTAINER_END, instances_size);
         };
@@ -183,15 +231,60 @@ namespace bal {
             if (this->instances_.data_[instance_offset] == CONTAINER_END) {
                 // the instance list is empty
                 assert(instances_last_.data_[instance_offset] == CONTAINER_END);
-                this->instances_.data_[instance_offset] = this->size_;
+                link_first(instance_offset, this->size_);
             } else {
                 // after the last item
                 assert(instances_last_.data_[instance_offset] != CONTAINER_END);
-                this->data_[instances_last_.data_[instance_offset]].next_offset = this->size_;
+                link_next(instances_last_.data_[instance_offset], this->size_);
             }
-            instances_last_.data_[instance_offset] = this->size_;
+            link_last(instance_offset, this->size_);
             this->size_++;
         };
+        
+        inline void transaction_begin() {
+            instances_last_log_sizes_.push_back(instances_last_log_.size_);
+            base_t::transaction_begin();
+        };
+        
+        inline void transaction_commit() {
+            base_t::transaction_commit();
+            instances_last_log_sizes_.pop_back();
+            if (instances_last_log_sizes_.empty()) {
+                instances_last_log_.size_ = 0;
+            };
+        };
+        
+        inline void transaction_rollback() {
+            base_t::transaction_rollback();
+            instances_last_log_sizes_.pop_back();
+        };
+
+        // container offsets change according to the map, e.g. after the container is compacted
+        // items referring to removed offsets are dropped together with those unlinked by iterators
+        // remaining items are appended anew in their original sequence
+        // so that index offsets stay ordered as container offsets across instances
+        inline void remap(const ContainerOffsetsMap& map) {
+            _assert_level_1(!this->transaction_is_in());
+            std::vector<container_offset_t> item_instances(this->size_, CONTAINER_END);
+            for (auto i = 0; i < this->instances_.size_; i++) {
+                container_offset_t offset = this->instances_.data_[i];
+                while (offset != CONTAINER_END) {
+                    item_instances[offset] = i;
+                    offset = this->data_[offset].next_offset;
+                };
+            };
+            
+            Container<list_index_item_t> items(std::move(*static_cast<Container<list_index_item_t>*>(this)));
+            reset(this->instances_.size_, items.size_);
+            for (container_offset_t offset = 0; offset < items.size_; offset++) {
+                if (item_instances[offset] != CONTAINER_END) {
+                    const container_offset_t container_offset = map(items.data_[offset].container_offset);
+                    if (container_offset != CONTAINER_END) {
+                        append(item_instances[offset], container_offset);
+                    };
+                };
+            };
+        };
     };
     
     // iterates items for the specified list instance
@@ -201,13 +294,13 @@ namespace bal {
     template<typename CONTAINER_DATA_T, class FILTER_T, typename Filterable<FILTER_T>::is_included_t IS_INCLUDED>
     class SimpleLinkedListsIndexInstanceFilteredOptimizingOffsetIterator {
     private:
-        const SimpleLinkedListsIndex<CONTAINER_DATA_T>& index_;
+        SimpleLinkedListsIndex<CONTAINER_DATA_T>& index_;
         container_offset_t instance_offset_ = CONTAINER_END;
         container_offset_t item_offset_ = CONTAINER_END;
         const FILTER_T& filter_;
         
     public:
-        SimpleLinkedListsIndexInstanceFilteredOptimizingOffsetIterator(const SimpleLinkedListsIndex<CONTAINER_DATA_T>& index, const FILTER_T& filter): index_(index), filter_(filter) {};
+        SimpleLinkedListsIndexInstanceFilteredOptimizingOffsetIterator(SimpleLinkedListsIndex<CONTAINER_DATA_T>& index, const FILTER_T& filter): index_(index), filter_(filter) {};
         
         inline container_offset_t first(const container_offset_t instance_offset) {
             instance_offset_ = instance_offset;
@@ -233,10 +326,10 @@ namespace bal {
                         item_offset_ = next_item_offset;
                         return result;
                     } else {
-                        index_data[item_offset_].next_offset = index_data[next_item_offset].next_offset;
+                        index_.link_next(item_offset_, index_data[next_item_offset].next_offset);
                     };
                 } else {
-                    index_.instances_last_.data_[instance_offset_] = item_offset_;
+                    index_.link_last(instance_offset_, item_offset_);
                     item_offset_ = CONTAINER_END;
                 };
             };
@@ -261,7 +354,7 @@ namespace bal {
         } state_t;
         
     private:
-        const SimpleLinkedListsIndex<CONTAINER_DATA_T>& index_;
+        SimpleLinkedListsIndex<CONTAINER_DATA_T>& index_;
         state_t state_[INSTANCES_SIZE];
         state_t* p_current_state_; // state with minimal index_offset
         container_offset_t data_offset_; // last accessed value; index cannot change
@@ -273,7 +366,7 @@ namespace bal {
         const FILTER_T& filter_;
         
     public:
-        SimpleLinkedListsIndexMergedFilteredOptimizingInstanceOffsetIterator(const SimpleLinkedListsIndex<CONTAINER_DATA_T>& index, const FILTER_T& filter): index_(index), filter_(filter) {};
+        SimpleLinkedListsIndexMergedFilteredOptimizingInstanceOffsetIterator(SimpleLinkedListsIndex<CONTAINER_DATA_T>& index, const FILTER_T& filter): index_(index), filter_(filter) {};
         
         const uint32_t& instance_bits = instance_bits_;
         
@@ -387,9 +480,9 @@ namespace bal {
                         // 2. update the sorted state list if necessary
                         p_state->index_offset = index_data[p_state->index_offset].next_offset;
                         if (p_state->index_offset_prev == CONTAINER_END) {
-                            index_.instances_.data_[p_state->instance_offset] = p_state->index_offset;
+                            index_.link_first(p_state->instance_offset, p_state->index_offset);
                         } else {
-                            index_data[p_state->index_offset_prev].next_offset = p_state->index_offset;
+                            index_.link_next(p_state->index_offset_prev, p_state->index_offset);
                         };
                         // if CONTAINER_END, exclude p_state and update instances_last_
                         // otherwise, reposition p_state within the sorted list
@@ -414,7 +507,7 @@ namespace bal {
                             // keep the lower value; normally, the last element can only grow
                             if (p_state->index_offset_prev == CONTAINER_END ||
                                 index_.instances_last_.data_[p_state->instance_offset] > p_state->index_offset_prev) {
-                                index_.instances_last_.data_[p_state->instance_offset] = p_state->index_offset_prev;
+                                index_.link_last(p_state->instance_offset, p_state->index_offset_prev);
                             };
                             // last index element is the same or greater than the first one
                             _assert_level_4(index_.instances_.data_[p_state->instance_offset] <= index_.instances_last_.data_[p_state->instance_offset]);
@@ -112,7 +112,27 @@ namespace bal {
             
             return result;
         };
-        
+
+        // same as resolve, also makes each variable on the way refer to the result (path compression)
+        // the table remains a union-find forest: the result is still the root with the lowest id,
+        // so that references to lower ids only are preserved
+        inline static literalid_t resolve_compress(literalid_t* const table, const literalid_t value) {
+            const literalid_t result = resolve(table, value);
+            if (!literal_t__is_unassigned(result)) {
+                literalid_t literal = value;
+                while (literal_t__is_variable(literal)) {
+                    literalid_t& reference = table[literal_t__variable_id(literal)];
+                    const literalid_t next = literal_t__substitute_literal(literal, reference);
+                    if (next == literal) {
+                        break;
+                    };
+                    reference = literal_t__substitute_literal(literal, result);
+                    literal = next;
+                };
+            };
+            return result;
+        };
+
         // DIMACS compatible representation
         
         friend std::ostream& operator << (std::ostream& stream, const literal_t& value) {
@@ -15,6 +15,7 @@
 #include "variablesarray.hpp"
 #include "formula.hpp"
 #include "cnfclausescontainer.hpp"
+#include "cnfreconstruction.hpp"
 
 // TODO: review ; aaaaaaa
 // 2) consider returning p_clause from iterators instead of offset
@@ -29,24 +30,52 @@
 
 namespace bal {
     
-    class Cnf: public Formula, protected CnfClausesIndexedContainer<COMPARE_CLAUSES_LEFT_RIGHT> {
+    // CNF_CLAUSES_HASH_INDEX build flag selects the hash table clauses index
+    // CNF_CLAUSES_BPLUS_INDEX build flag selects the B+ tree clauses index
+#if defined(CNF_CLAUSES_HASH_INDEX)
+    using cnf_clauses_index_t = cnf_clauses_hash_index_t<COMPARE_CLAUSES_LEFT_RIGHT>;
+#elif defined(CNF_CLAUSES_BPLUS_INDEX)
+    using cnf_clauses_index_t = cnf_clauses_bplus_index_t<COMPARE_CLAUSES_LEFT_RIGHT>;
+#else
+    using cnf_clauses_index_t = cnf_clauses_avl_index_t<COMPARE_CLAUSES_LEFT_RIGHT>;
+#endif
+    
+    class Cnf: public Formula, protected CnfClausesIndexedContainer<COMPARE_CLAUSES_LEFT_RIGHT, cnf_clauses_index_t> {
     public:
-        using clauses_container_t = CnfClausesIndexedContainer<COMPARE_CLAUSES_LEFT_RIGHT>;
+        using clauses_container_t = CnfClausesIndexedContainer<COMPARE_CLAUSES_LEFT_RIGHT, cnf_clauses_index_t>;
         using insertion_point_t = typename clauses_container_t::insertion_point_t;
         
         friend class CnfProcessor;
         
     private:
+        // clauses removed by processing which a model of the formula may falsify
+        CnfReconstructionStack reconstruction_;
+        
         inline void __set_variables_size(const variableid_t value) {
             VariableGenerator::reset(value);
-            // if value is higher, the index will be updated when needed
+            // if value is higher, add empty instances since roots beyond the size may be stale
             // if the value is lower, simply disregard the unnecessary part
-            this->instances_.size_ = value;
+            if (value > this->instances_.size_) {
+                this->instances_.append(CONTAINER_END, value - this->instances_.size_);
+            } else {
+                this->instances_.size_ = value;
+            };
         };
         
     public:
+        // clauses are allocated on the heap unless set_clauses_allocation() reserves an address range for them
+        Cnf() = default;
+        
+        // a reserved address range keeps clause pointers valid while the formula grows,
+        // huge pages reduce TLB pressure for large formulas; see container_allocation_t
+        inline void set_clauses_allocation(const container_allocation_t allocation,
+                                           const container_size_t max_size = CONTAINER_SIZE_MAX) {
+            clauses_container_t::set_allocation(allocation, max_size);
+        };
+        
         void initialize() override {
             Formula::initialize();
+            reconstruction_.clear();
             resize(0, 0);
         };
          
@@ -79,11 +108,36 @@ namespace bal {
     public:
         using clauses_container_t::append_clause;
         using clauses_container_t::append_clause_l;
+        using clauses_container_t::bulk_load_begin;
+        using clauses_container_t::bulk_load_is_in;
+        using clauses_container_t::bulk_load_append_clause;
+        using clauses_container_t::bulk_load_commit;
         using clauses_container_t::clauses;
+        using clauses_container_t::clauses_ordered;
         using clauses_container_t::clauses_size;
         using clauses_container_t::find;
         using clauses_container_t::memory_size;
+        using clauses_container_t::share;
+        using clauses_container_t::set_build_threads;
+
+        // makes this formula a copy of the other one
+        // clauses are mapped copy-on-write if the other formula is shared
+        // variables and the index are copied as they are now, see CnfClausesIndexedContainer::snapshot
+        inline void snapshot(const Cnf& other) {
+            Formula::operator=(other);
+            reconstruction_ = other.reconstruction_;
+            clauses_container_t::snapshot(other);
+        };
         
+        // the clauses removed are mapped along with named variables
+        inline void named_variables_update(const VariablesArray& source) {
+            Formula::named_variables_update(source);
+            reconstruction_.update(source);
+        };
+        
+        inline CnfReconstructionStack& reconstruction() { return reconstruction_; };
+        inline const CnfReconstructionStack& reconstruction() const { return reconstruction_; };
+
         void record_clauses(const char* const * const map, const std::size_t map_size,
                             literalid_t args[], const std::size_t input_size, const std::size_t output_size) {
             assert(map_size > 0 && input_size > 0 && output_size > 0);
@@ -11,10 +11,10 @@
 
 namespace bal {
     
-    unsigned __find_clause_found = 0;
-    unsigned __find_clause_unfound = 0;
-    unsigned __compare_clauses_ = 0;
-    unsigned __append_clause_ = 0;
+    thread_local unsigned __find_clause_found = 0;
+    thread_local unsigned __find_clause_unfound = 0;
+    thread_local unsigned __compare_clauses_ = 0;
+    thread_local unsigned __append_clause_ = 0;
     std::chrono::time_point<std::chrono::system_clock> __time_start_;
     
     // Cnf
@@ -51,5 +51,18 @@ namespace bal {
             std::cout << literal_t(variable_t__literal_id(variable_id)) << " = " << literal_t(value_id) << std::endl;
         };
     };
+    
+    void __print_conflict(const literalid_t variables[], const uint32_t* const p_clause1, const uint32_t* const p_clause2,
+                          const variableid_t variable_id) {
+        std::cout << "CONFLICT" << std::endl;
+        std::cout << "Clause(s):" << std::endl;
+        __print_clause(p_clause1);
+        if (p_clause2 != p_clause1) {
+            __print_clause(p_clause2);
+        };
+        std::cout << "Variable(s):" << std::endl;
+        const literalid_t value_id = literal_t::resolve(variables, variable_t__literal_id(variable_id));
+        std::cout << literal_t(variable_t__literal_id(variable_id)) << " = " << literal_t(value_id) << std::endl;
+    };
 
 };
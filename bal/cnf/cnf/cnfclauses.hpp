@@ -108,10 +108,11 @@ constexpr uint8_t __c2_combination_index[16] = {
     
 #define _c2_is_single_clause_flags(value) ((value) == 0b0001 || (value) == 0b0010 || (value) == 0b0100 || (value) == 0b1000)
     
-    extern unsigned __find_clause_found;
-    extern unsigned __find_clause_unfound;
-    extern unsigned __compare_clauses_;
-    extern unsigned __append_clause_;
+    // counted per thread, clauses may be sorted and formulas processed by several threads
+    extern thread_local unsigned __find_clause_found;
+    extern thread_local unsigned __find_clause_unfound;
+    extern thread_local unsigned __compare_clauses_;
+    extern thread_local unsigned __append_clause_;
     extern unsigned __normalize_clause_;
     
     // assume the first SAME_LITERALS are the same
@@ -144,6 +145,32 @@ constexpr uint8_t __c2_combination_index[16] = {
         return lhs_size < rhs_size ? -1 : (lhs_size == rhs_size ? 0 : 1);
     };
     
+    // hash value of the clause consistent with compare_clauses
+    // i.e. depends on size and literals, not on flags
+    inline uint32_t hash_clause(const uint32_t* const p_clause) {
+        const clause_size_t size = _clause_size(p_clause);
+        uint32_t result = 0x811C9DC5 ^ size;
+        for (auto i = 1; i <= size; i++) {
+            result = (result ^ p_clause[i]) * 0x01000193;
+        };
+        // finalization mixes high bits into low ones used for addressing
+        result ^= result >> 16;
+        result *= 0x85EBCA6B;
+        result ^= result >> 13;
+        return result;
+    };
+    
+    // key prefix of the clause consistent with compare_clauses
+    // i.e. first literals in the comparison order, zero where the clause is shorter
+    // zero is smaller than any literal as the shorter clause is smaller
+    template<bool compare_left_right = true>
+    inline void clause_key_prefix(const uint32_t* const p_clause, uint32_t* const key) {
+        const clause_size_t size = _clause_size(p_clause);
+        for (auto i = 0; i < 3; i++) {
+            key[i] = i < size ? p_clause[compare_left_right ? i + 1 : size - i] : 0;
+        };
+    };
+    
     inline uint16_t get_cardinality_uint16(const uint16_t value) {
         // 0  1  2  3  4  5  6  7  8  9  a  b  c  d  e  f
         const uint16_t map[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
@@ -332,6 +359,48 @@ constexpr uint8_t __c2_combination_index[16] = {
         flags = ((flags & map1[index]) >> shift) | ((flags & map0[index]) << shift);
     };
     
+    // removes literal <index> with the constant value from the aggregated clause flags
+    inline void ca_flags_reduce(uint16_t& flags, const clause_size_t index, const literalid_t value) {
+        switch ((index << 1) + value) {
+            case 0: // variable 0, value 0
+                flags =
+                (flags & 0x0002) >> 1 | (flags & 0x0008) >> 2 |
+                (flags & 0x0020) >> 3 | (flags & 0x0080) >> 4 |
+                (flags & 0x0200) >> 5 | (flags & 0x0800) >> 6 |
+                (flags & 0x2000) >> 7 | (flags & 0x8000) >> 8;
+                break;
+            case 1: // variable 0, value 1
+                flags =
+                (flags & 0x0001)      | (flags & 0x0004) >> 1 |
+                (flags & 0x0010) >> 2 | (flags & 0x0040) >> 3 |
+                (flags & 0x0100) >> 4 | (flags & 0x0400) >> 5 |
+                (flags & 0x1000) >> 6 | (flags & 0x4000) >> 7;
+                break;
+            case 2: // variable 1, value 0
+                flags =
+                (flags & 0x000C) >> 2 | (flags & 0x00C0) >> 4 |
+                (flags & 0x0C00) >> 6 | (flags & 0xC000) >> 8;
+                break;
+            case 3: // variable 1, value 1
+                flags =
+                (flags & 0x0003)      | (flags & 0x0030) >> 2 |
+                (flags & 0x0300) >> 4 | (flags & 0x3000) >> 6;
+                break;
+            case 4: // variable 2, value 0
+                flags = (flags & 0x00F0) >> 4 | (flags & 0xF000) >> 8;
+                break;
+            case 5: // variable 2, value 1
+                flags = (flags & 0x000F)      | (flags & 0x0F00) >> 4;
+                break;
+            case 6: // variable 3, value 0
+                flags = (flags & 0xFFFF) >> 8;
+                break;
+            case 7: // variable 3, value 1
+                flags = (flags & 0x00FF);
+                break;
+        };
+    };
+    
     // calculate aggregated clause flags assuming
     // literal <index> is matched with literal <c2_index>
     // c2_flags are required to be a single clause
@@ -486,6 +555,9 @@ constexpr uint8_t __c2_combination_index[16] = {
     void __statistics_print();
     
     void __print_conflict(const literalid_t variables[], const uint32_t* const p_clause);
+    // clauses with opposite literals of the variable whose resolvent is empty, may be the same aggregated clause
+    void __print_conflict(const literalid_t variables[], const uint32_t* const p_clause1, const uint32_t* const p_clause2,
+                          const variableid_t variable_id);
 };
 
 #endif /* cnfclauses_hpp */
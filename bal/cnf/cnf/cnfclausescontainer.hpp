@@ -8,9 +8,15 @@
 #ifndef cnfclausescontainer_hpp
 #define cnfclausescontainer_hpp
 
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <type_traits>
 #include "assertlevels.hpp"
 #include "container.hpp"
 #include "binarytreeindex.hpp"
+#include "hashtableindex.hpp"
+#include "bplustreeindex.hpp"
 #include "cnfclauses.hpp"
 
 namespace bal {
@@ -30,7 +36,7 @@ namespace bal {
 #define _clauses_offset_size(clauses, offset) _clause_size(_clauses_offset_clause(clauses, offset))
 #define _clauses_offset_literals(clauses, offset) _clause_literals(_clauses_offset_clause(clauses, offset))
 #define _clauses_offset_literal(clauses, offset, index) (*(_clause_literals(_clauses_offset_clause(clauses, offset)) + (index)))
-
+    
     // notes:
     //   1. inclusion/exclusion is only used for processing
     //   2. inclusion is only used for rolling back changes and restoring of original clauses
@@ -41,19 +47,35 @@ namespace bal {
 #define _clauses_offset_size_next(offset, clause_size) (offset) += _clauses_offset_size_memory_size(clause_size)
 #define _clauses_offset_next(offset, p_clause) _clauses_offset_size_next(offset, _clause_size(p_clause))
     
+    // fewer clauses are sorted and indexed faster by a single thread
+#define CLAUSES_BUILD_CONCURRENT_SIZE_MIN 0x10000
+    // number of instances a thread takes at once
+#define CLAUSES_BUILD_CONCURRENT_CHUNK_SIZE 64
+    
     template<bool compare_left_right>
     inline container_offset_t clause_index_variable_id(const uint32_t* const p_clause) {
         return literal_t__variable_id(_clause_literal(p_clause, compare_left_right ? 0 : _clause_size(p_clause) - 1));
     };
     
-    // clauses are stored within the container
-    // with binary tree index data for each clause
     // binary tree index orders clauses according to specified criteria
-    // see cnfclauses.hpp for clause memory sctructure
     template<bool compare_left_right>
-    class CnfClausesIndexedContainer: public AvlTreesIndex<uint32_t, true, compare_clauses<compare_left_right>, clause_index_variable_id<compare_left_right>> {
+    using cnf_clauses_avl_index_t = AvlTreesIndex<uint32_t, true, compare_clauses<compare_left_right>, clause_index_variable_id<compare_left_right>>;
+    
+    // hash table index finds clauses without comparing along a path; clauses are not ordered
+    template<bool compare_left_right>
+    using cnf_clauses_hash_index_t = HashTablesIndex<uint32_t, true, compare_clauses<compare_left_right>, hash_clause, clause_index_variable_id<compare_left_right>>;
+    
+    // B+ tree index keeps clauses ordered; most comparisons only involve key prefixes within nodes
+    template<bool compare_left_right>
+    using cnf_clauses_bplus_index_t = BPlusTreesIndex<uint32_t, true, compare_clauses<compare_left_right>, clause_key_prefix<compare_left_right>, clause_index_variable_id<compare_left_right>>;
+    
+    // clauses are stored within the container
+    // with index data for each clause, 3 words in front of it
+    // see cnfclauses.hpp for clause memory sctructure
+    template<bool compare_left_right, typename INDEX_T = cnf_clauses_avl_index_t<compare_left_right>>
+    class CnfClausesIndexedContainer: public INDEX_T {
     public:
-        using base_t = AvlTreesIndex<uint32_t, true, compare_clauses<compare_left_right>, clause_index_variable_id<compare_left_right>>;
+        using base_t = INDEX_T;
         using insertion_point_t = typename base_t::insertion_point_t;
         
         CnfClausesIndexedContainer() = default;
@@ -86,36 +108,240 @@ namespace bal {
             return validated_size;
         };
         
-    protected:
-        // simply rebuild the index on rollback, with rebalancing
+        // offset of the first clause appended without indexing, CONTAINER_END unless bulk loading
+        container_offset_t bulk_load_offset_ = CONTAINER_END;
+        // offset of the last clause appended without indexing, CONTAINER_END if none
+        container_offset_t bulk_load_last_offset_ = CONTAINER_END;
+        
+        // number of threads sorting and indexing clauses at once, 0 for all hardware threads
+        unsigned build_threads_ = 0;
+        
+        // clauses appended within the outermost transaction, by offset asc, unless the index logs its changes
+        // a savepoint is rolled back by rebuilding the index from these and the immutable clauses
+        std::vector<container_offset_t> transaction_appended_;
+        
+        // calls f(instance_offset) for each instance, from several threads if there are enough clauses
+        // instances are taken in chunks because their sizes vary a lot
+        template<typename F>
+        inline void for_each_instance(const std::vector<container_size_t>& instance_starts, const F& f) const {
+            const container_size_t instances_size = (container_size_t)(instance_starts.size() - 1);
+            unsigned threads_size = build_threads_ == 0 ? std::thread::hardware_concurrency() : build_threads_;
+            if (instance_starts.back() < CLAUSES_BUILD_CONCURRENT_SIZE_MIN || instances_size < 2) {
+                threads_size = 1;
+            };
+            if (threads_size <= 1) {
+                for (container_size_t i = 0; i < instances_size; i++) {
+                    f(i);
+                };
+                return;
+            };
+            
+            std::atomic<container_size_t> next(0);
+            auto worker = [&]() {
+                container_size_t i;
+                while ((i = next.fetch_add(CLAUSES_BUILD_CONCURRENT_CHUNK_SIZE)) < instances_size) {
+                    const container_size_t end = std::min(i + CLAUSES_BUILD_CONCURRENT_CHUNK_SIZE, instances_size);
+                    for (; i < end; i++) {
+                        f(i);
+                    };
+                };
+            };
+            std::vector<std::thread> threads;
+            for (auto i = 1; i < threads_size; i++) {
+                threads.emplace_back(worker);
+            };
+            worker();
+            for (auto& thread: threads) {
+                thread.join();
+            };
+        };
+        
+        inline container_offset_t clause_instance(const container_offset_t offset) const {
+            return clause_index_variable_id<compare_left_right>(_clauses_offset_clause(this->data_, offset));
+        };
+        
+        // orders clause offsets by instance with an in place counting sort then by compare_clauses within each instance
+        // equal clauses stay in the container sequence; instance_starts receives boundaries of instances
+        // the instance is taken from the clause each time so that no other array of the size of offsets is needed
+        inline void sort_clauses(std::vector<container_offset_t>& offsets, std::vector<container_size_t>& instance_starts) const {
+            instance_starts.clear();
+            for (auto i = 0; i < offsets.size(); i++) {
+                const container_offset_t instance_offset = clause_instance(offsets[i]);
+                if (instance_offset + 2 > instance_starts.size()) {
+                    instance_starts.resize(instance_offset + 2, 0);
+                };
+                instance_starts[instance_offset + 1]++;
+            };
+            if (instance_starts.empty()) {
+                instance_starts.push_back(0);
+            };
+            const container_size_t instances_size = (container_size_t)(instance_starts.size() - 1);
+            for (auto i = 0; i < instances_size; i++) {
+                instance_starts[i + 1] += instance_starts[i];
+            };
+            
+            // each offset is swapped into the next free position of its instance until the instance is filled
+            {
+                std::vector<container_size_t> positions(instance_starts.begin(), instance_starts.end() - 1);
+                for (container_size_t i = 0; i < instances_size; i++) {
+                    while (positions[i] < instance_starts[i + 1]) {
+                        const container_offset_t instance_offset = clause_instance(offsets[positions[i]]);
+                        if (instance_offset == i) {
+                            positions[i]++;
+                        } else {
+                            std::swap(offsets[positions[i]], offsets[positions[instance_offset]++]);
+                        };
+                    };
+                };
+            };
+            
+            const uint32_t* const data = this->data_;
+            for_each_instance(instance_starts, [data, &offsets, &instance_starts](const container_size_t i) {
+                if (instance_starts[i + 1] - instance_starts[i] > 1) {
+                    std::sort(offsets.begin() + instance_starts[i], offsets.begin() + instance_starts[i + 1],
+                              [data](const container_offset_t lhs, const container_offset_t rhs) {
+                        const int result = compare_clauses<compare_left_right>(_clauses_offset_clause(data, lhs), _clauses_offset_clause(data, rhs));
+                        return result < 0 || (result == 0 && lhs < rhs);
+                    });
+                };
+            });
+        };
+        
+        inline void build_index_(std::false_type, const std::vector<container_offset_t>& offsets, const std::vector<container_size_t>& instance_starts) {
+            for (container_offset_t i = 0; i + 1 < instance_starts.size(); i++) {
+                if (instance_starts[i + 1] > instance_starts[i]) {
+                    base_t::build(i, offsets.data() + instance_starts[i], instance_starts[i + 1] - instance_starts[i]);
+                };
+            };
+        };
+        
+        // instances are added upfront, then each thread builds its own instances
+        inline void build_index_(std::true_type, const std::vector<container_offset_t>& offsets, const std::vector<container_size_t>& instance_starts) {
+            const container_size_t instances_size = (container_size_t)(instance_starts.size() - 1);
+            this->insertion_point_invalidate();
+            if (instances_size > this->instances_.size_) {
+                this->instances_.append(CONTAINER_END, instances_size - this->instances_.size_);
+            };
+            for_each_instance(instance_starts, [this, &offsets, &instance_starts](const container_size_t i) {
+                if (instance_starts[i + 1] > instance_starts[i]) {
+                    base_t::build_concurrent(i, offsets.data() + instance_starts[i], instance_starts[i + 1] - instance_starts[i]);
+                };
+            });
+        };
+        
+        // builds each instance of the empty index from sorted clauses without duplicates
+        inline void build_index(const std::vector<container_offset_t>& offsets, const std::vector<container_size_t>& instance_starts) {
+            _assert_level_1(!this->transaction_is_in());
+            build_index_(std::integral_constant<bool, base_t::is_build_concurrent>(), offsets, instance_starts);
+        };
+        
+        // restores the index from its undo log, see ContainerIndex::rollback
+        inline void rollback_(std::true_type,
+                              const container_size_t size,
+                              const container_size_t instances_size,
+                              const container_size_t container_size) {
+            base_t::rollback(size, instances_size, container_size);
+        };
+        
+        // rebuilds the index from the immutable clauses for an index not logging its changes
         // this is because of "replacement" of items which is a modification rather than addition
-        // also, rebalancing is needed anyway
+        // items unlinked within the transaction are linked again by the undo log;
+        // the same clauses are indexed as before the transaction began
         // can use offset increments and _clauses_offset_next because its only immutable clauses
-        void rollback(const container_size_t size,
-                      const container_size_t instances_size,
-                      const container_size_t container_size) override {
+        // for a savepoint, clauses appended within the enclosing transactions may have been shortened in place,
+        // so those are taken from transaction_appended_ instead
+        inline void rollback_(std::false_type,
+                              const container_size_t size,
+                              const container_size_t instances_size,
+                              const container_size_t container_size) {
+            const container_size_t immutable_size = this->transaction_is_in() ? this->transaction_outermost_immutable_size() : container_size;
+            while (!transaction_appended_.empty() && transaction_appended_.back() >= container_size) {
+                transaction_appended_.pop_back();
+            };
+            std::vector<container_offset_t> offsets;
+            for (auto offset: transaction_appended_) {
+                if (base_t::is_indexed(offset)) {
+                    offsets.push_back(offset);
+                };
+            };
+            if (!this->transaction_is_in()) {
+                transaction_appended_.clear();
+            };
+            
             base_t::rollback(0, 0, container_size);
             this->instances_.append(CONTAINER_END, instances_size);
+            this->size_ = container_size;
             container_offset_t container_offset = 0;
-            while (container_offset < container_size) {
-                uint32_t* const p_clause = _clauses_offset_clause(this->p_container_->data_, container_offset);
-                _clause_include(p_clause);
-                insertion_point_t insertion_point;
-                this->find(p_clause, insertion_point);
-                _assert_level_1(insertion_point.container_offset == CONTAINER_END);
-                base_t::_update(container_offset, insertion_point);
-                _clauses_offset_next(container_offset, p_clause);
-                this->size_ = container_offset; // "commits" the clause
+            while (container_offset < immutable_size) {
+                if (base_t::is_indexed(container_offset)) {
+                    offsets.push_back(container_offset);
+                };
+                _clauses_offset_next(container_offset, _clauses_offset_clause(this->data_, container_offset));
+            };
+            
+            std::vector<container_size_t> instance_starts;
+            sort_clauses(offsets, instance_starts);
+            for (auto i = 1; i < offsets.size(); i++) {
+                _assert_level_1(compare_clauses<compare_left_right>(_clauses_offset_clause(this->data_, offsets[i - 1]),
+                                                                    _clauses_offset_clause(this->data_, offsets[i])) != 0);
             };
+            // a savepoint may be rolled back within the enclosing transaction; the words written are not logged,
+            // which is fine since the enclosing transaction is rolled back by rebuilding as well
+            build_index_(std::integral_constant<bool, base_t::is_build_concurrent>(), offsets, instance_starts);
+        };
+        
+    protected:
+        // the cost of rolling back is proportional to the changes made within the transaction
+        // unless the index has to be rebuilt
+        void rollback(const container_size_t size,
+                      const container_size_t instances_size,
+                      const container_size_t container_size) override {
+            rollback_(std::integral_constant<bool, base_t::is_transaction_logged>(), size, instances_size, container_size);
         };
         
     public:
         CnfClausesIndexedContainer(const Container<uint32_t>& container): base_t(container) {};
         
         // clauses list ordered using clauses_index_
-        using clauses_iterable_t = ContainerIterable<CnfClausesIndexedContainer<compare_left_right>, ContainerIndexIterator>;
+        using clauses_iterable_t = ContainerIterable<CnfClausesIndexedContainer, ContainerIndexIterator>;
         clauses_iterable_t clauses() const { return clauses_iterable_t(*this); };
         
+        // begins a transaction or a savepoint within the current one, see ContainerIndex::transaction_begin
+        inline void transaction_begin() {
+            if (!this->transaction_is_in()) {
+                transaction_appended_.clear();
+            };
+            base_t::transaction_begin();
+        };
+        
+    private:
+        inline clauses_iterable_t clauses_ordered_(std::true_type) const { return clauses(); };
+        
+        // sort once instead of keeping the index ordered
+        inline std::vector<const uint32_t*> clauses_ordered_(std::false_type) const {
+            std::vector<const uint32_t*> result;
+            for (auto it: clauses()) {
+                result.push_back(it);
+            };
+            std::sort(result.begin(), result.end(), [](const uint32_t* const lhs, const uint32_t* const rhs) {
+                const uint32_t* const p_lhs = _clauses_offset_item_clause(lhs);
+                const uint32_t* const p_rhs = _clauses_offset_item_clause(rhs);
+                const container_offset_t lhs_instance = clause_index_variable_id<compare_left_right>(p_lhs);
+                const container_offset_t rhs_instance = clause_index_variable_id<compare_left_right>(p_rhs);
+                return lhs_instance < rhs_instance ||
+                    (lhs_instance == rhs_instance && compare_clauses<compare_left_right>(p_lhs, p_rhs) < 0);
+            });
+            return result;
+        };
+        
+    public:
+        // clauses list ordered by instance then by compare_clauses regardless of the index kind
+        // same sequence as clauses() for an ordered index; for the output
+        using clauses_ordered_t = typename std::conditional<base_t::is_ordered, clauses_iterable_t, std::vector<const uint32_t*>>::type;
+        clauses_ordered_t clauses_ordered() const {
+            return clauses_ordered_(std::integral_constant<bool, base_t::is_ordered>());
+        };
+        
         // clause_size - 0 means count clauses of all lengths, otherwise specified length only
         // aggregated - count aggregates if true, otherwise count individual clauses
         template<const clause_size_t clause_size = 0, bool aggregated = false, bool literals = false>
@@ -135,6 +361,60 @@ namespace bal {
             return result;
         };
         
+        // removes obsolete excluded clauses beyond the transaction bound from the index and the container
+        // remaining clauses are moved towards the beginning keeping their sequence
+        // only indexed clauses are kept since memory size of an unindexed one may be unknown;
+        // the map describes the move for updating offsets kept elsewhere
+        // is_clause_obsolete(p_clause) decides if an excluded clause can be dropped
+        template<typename IS_CLAUSE_OBSOLETE_T>
+        inline void compact(const IS_CLAUSE_OBSOLETE_T& is_clause_obsolete, ContainerOffsetsMap& map) {
+            std::vector<container_offset_t> offsets;
+            for (auto it: clauses()) {
+                offsets.push_back((container_offset_t)(it - this->data_));
+            };
+            std::sort(offsets.begin(), offsets.end());
+            
+            map.reset(this->transaction_immutable_size());
+            container_offset_t new_offset = map.base();
+            for (auto i = 0; i < offsets.size(); i++) {
+                const container_offset_t offset = offsets[i];
+                const uint32_t* const p_clause = _clauses_offset_clause(this->data_, offset);
+                if (offset < map.base()) {
+                    map.append(offset, offset);
+                } else if (_clause_is_included(p_clause) || !is_clause_obsolete(p_clause)) {
+                    map.append(offset, new_offset);
+                    _clauses_offset_size_next(new_offset, _clause_size(p_clause));
+                } else {
+                    base_t::remove(offset);
+                    map.append(offset, CONTAINER_END);
+                };
+            };
+            map.set_new_size(new_offset);
+            
+            // references are updated in place then moved together with the clauses
+            base_t::remap(map);
+            for (auto i = 0; i < map.size(); i++) {
+                const container_offset_t offset = map.offset(i);
+                if (map.new_offset(i) != CONTAINER_END && map.new_offset(i) != offset) {
+                    const uint32_t* const p_item = _clauses_offset_item(this->data_, offset);
+                    std::copy(p_item, p_item + _clauses_offset_size_memory_size(_clauses_offset_size(this->data_, offset)),
+                              _clauses_offset_item(this->data_, map.new_offset(i)));
+                };
+            };
+            this->size_ = new_offset;
+        };
+        
+        // excludes the clause; a clause within the transaction bound is included again on rollback
+        inline void exclude(const container_offset_t offset) {
+            if (this->transaction_offset_is_immutable(offset)) {
+                uint32_t header = _clauses_offset_header(this->data_, offset);
+                _clause_exclude(&header);
+                this->transaction_set((container_offset_t)(_clauses_offset_clause(this->data_, offset) - this->data_), header);
+            } else {
+                _clauses_offset_exclude(this->data_, offset);
+            };
+        };
+        
         inline container_offset_t find(const uint32_t* const p_object) const {
             container_offset_t result = base_t::find(p_object);
             
@@ -211,8 +491,10 @@ namespace bal {
                 };
                 // clause not added yet but clauses_size_ is its valid offset
                 base_t::_update(this->size_, insertion_point);
-                insertion_point.kind = btipkCurrent;
-                insertion_point.container_offset = this->size_;
+                if (!base_t::is_transaction_logged && this->transaction_is_in()) {
+                    transaction_appended_.push_back(this->size_);
+                };
+                base_t::insertion_point_set_current(insertion_point, this->size_);
                 _clauses_offset_size_next(this->size_, clause_size); // "commits" the clause
             } else if (_clause_size_is_aggregated(clause_size)) {
                 // a matching aggregated clause is found; it is enough to merge headers
@@ -238,6 +520,17 @@ namespace bal {
         //   for all other clauses
         //      adds the clause unless its a duplicate
         inline void append_clause(const literalid_t* const literals, const clause_size_t literals_size) {
+            uint32_t* const p_clause = append_clause_unindexed(literals, literals_size);
+            
+            insertion_point_t insertion_point;
+            __insertion_point_t_init(insertion_point);
+            append<false>(p_clause, insertion_point);
+        };
+        
+    private:
+        // copies the literals to the end of the container and normalizes the clause there
+        // returns the clause which is not committed nor indexed; its size is 0 if it is always satisfied
+        inline uint32_t* append_clause_unindexed(const literalid_t* const literals, const clause_size_t literals_size) {
             this->reserve(_clauses_offset_size_memory_size(literals_size));
             uint32_t* const p_clause = _clauses_offset_clause(this->data_, this->size_);
             std::copy(literals, literals + literals_size, _clause_literals(p_clause));
@@ -258,12 +551,164 @@ namespace bal {
                 clause_flags = 0x1 << clause_bitmap;
             };
             _clause_header_set(p_clause, clause_flags, clause_size);
-            
-            insertion_point_t insertion_point;
-            __insertion_point_t_init(insertion_point);
-            append<false>(p_clause, insertion_point);
+            return p_clause;
+        };
+        
+    public:
+        // BULK LOAD
+        // many clauses are appended to the empty container without looking them up,
+        // then sorted, merged and indexed at once by bulk_load_commit;
+        // the result is the same as appending them one by one:
+        // the first of equal clauses is kept in place, flags of aggregated ones are merged into it
+        inline void bulk_load_begin() {
+            _assert_level_0(!this->transaction_is_in() && this->size_ == 0);
+            _assert_level_0(bulk_load_offset_ == CONTAINER_END);
+            bulk_load_offset_ = this->size_;
+            bulk_load_last_offset_ = CONTAINER_END;
+        };
+        
+        inline bool bulk_load_is_in() const {
+            return bulk_load_offset_ != CONTAINER_END;
         };
         
+        // clauses of different instances are sorted and indexed by different threads
+        // when there are at least CLAUSES_BUILD_CONCURRENT_SIZE_MIN of them; 0 uses all hardware threads
+        inline void set_build_threads(const unsigned value) {
+            build_threads_ = value;
+        };
+        
+        // appends a normalized clause; p_clause may be located in the container beyond its size
+        // a clause equal to the one appended last is merged into it at once, so that members of
+        // aggregated clauses, usually listed together, take no more memory than when indexed one by one
+        inline void bulk_load_append(const uint32_t* const p_clause) {
+            _assert_level_0(bulk_load_is_in());
+            _assert_level_0(_clause_is_included(p_clause));
+            const clause_size_t clause_size = _clause_size(p_clause);
+            _assert_level_0(clause_size != 0 && clause_size <= CLAUSE_SIZE_MAX);
+            if (bulk_load_last_offset_ != CONTAINER_END) {
+                uint32_t* const p_last = _clauses_offset_clause(this->data_, bulk_load_last_offset_);
+                if (compare_clauses<compare_left_right>(p_last, p_clause) == 0) {
+                    if (_clause_is_aggregated(p_clause)) {
+                        _clause_flags_include(p_last, _clause_flags(p_clause));
+                    };
+                    return;
+                };
+            };
+            bulk_load_last_offset_ = this->size_;
+            if (p_clause != _clauses_offset_clause(this->data_, this->size_)) {
+                this->reserve(_clauses_offset_size_memory_size(clause_size));
+                _clause_copy_size(p_clause, _clauses_offset_clause(this->data_, this->size_), clause_size);
+            };
+            _clauses_offset_size_next(this->size_, clause_size);
+        };
+        
+        // normalizes and appends the clause unless it is always satisfied
+        inline void bulk_load_append_clause(const literalid_t* const literals, const clause_size_t literals_size) {
+            const uint32_t* const p_clause = append_clause_unindexed(literals, literals_size);
+            if (_clause_size(p_clause) != 0) {
+                bulk_load_append(p_clause);
+            };
+        };
+        
+        inline void bulk_load_commit() {
+            _assert_level_0(bulk_load_is_in());
+            // counted first so that offsets are allocated once
+            container_size_t clauses_size = 0;
+            container_offset_t offset = bulk_load_offset_;
+            while (offset < this->size_) {
+                clauses_size++;
+                _clauses_offset_next(offset, _clauses_offset_clause(this->data_, offset));
+            };
+            std::vector<container_offset_t> offsets;
+            offsets.reserve(clauses_size);
+            offset = bulk_load_offset_;
+            while (offset < this->size_) {
+                offsets.push_back(offset);
+                _clauses_offset_next(offset, _clauses_offset_clause(this->data_, offset));
+            };
+            
+            std::vector<container_size_t> instance_starts;
+            sort_clauses(offsets, instance_starts);
+            
+            // duplicates follow the first of equal clauses; they are merged into it and excluded
+            container_size_t duplicates_size = 0;
+            container_size_t first = 0;
+            for (auto i = 1; i < offsets.size(); i++) {
+                uint32_t* const p_clause = _clauses_offset_clause(this->data_, offsets[i]);
+                if (compare_clauses<compare_left_right>(_clauses_offset_clause(this->data_, offsets[first]), p_clause) == 0) {
+                    if (_clause_is_aggregated(p_clause)) {
+                        _clauses_offset_flags_include(this->data_, offsets[first], _clause_flags(p_clause));
+                    };
+                    _clause_exclude(p_clause);
+                    duplicates_size++;
+                } else {
+                    first = i;
+                };
+            };
+            
+            if (duplicates_size > 0) {
+                // the first index word, unused until the index is built, keeps the new offset of the clause
+                container_offset_t new_offset = bulk_load_offset_;
+                offset = bulk_load_offset_;
+                while (offset < this->size_) {
+                    const clause_size_t clause_size = _clauses_offset_size(this->data_, offset);
+                    if (_clauses_offset_is_included(this->data_, offset)) {
+                        *_clauses_offset_item(this->data_, offset) = new_offset;
+                        _clauses_offset_size_next(new_offset, clause_size);
+                    } else {
+                        *_clauses_offset_item(this->data_, offset) = CONTAINER_END;
+                    };
+                    _clauses_offset_size_next(offset, clause_size);
+                };
+                
+                // duplicates are dropped from the sorted offsets adjusting instance boundaries
+                container_size_t size = 0;
+                container_size_t instance_start = 0;
+                for (auto i = 0; i + 1 < instance_starts.size(); i++) {
+                    for (auto j = instance_start; j < instance_starts[i + 1]; j++) {
+                        const container_offset_t moved_offset = *_clauses_offset_item(this->data_, offsets[j]);
+                        if (moved_offset != CONTAINER_END) {
+                            offsets[size++] = moved_offset;
+                        };
+                    };
+                    instance_start = instance_starts[i + 1];
+                    instance_starts[i + 1] = size;
+                };
+                offsets.resize(size);
+                
+                // clauses only move towards the beginning, never over the ones not moved yet
+                offset = bulk_load_offset_;
+                while (offset < this->size_) {
+                    const uint32_t* const p_clause = _clauses_offset_clause(this->data_, offset);
+                    const clause_size_t clause_size = _clause_size(p_clause);
+                    const container_offset_t moved_offset = *_clauses_offset_item(this->data_, offset);
+                    if (moved_offset != CONTAINER_END && moved_offset != offset) {
+                        _clause_copy_size(p_clause, _clauses_offset_clause(this->data_, moved_offset), clause_size);
+                    };
+                    _clauses_offset_size_next(offset, clause_size);
+                };
+                this->size_ = new_offset;
+            };
+            
+            build_index(offsets, instance_starts);
+            bulk_load_offset_ = CONTAINER_END;
+            bulk_load_last_offset_ = CONTAINER_END;
+        };
+
+        // SNAPSHOTS
+        // see SNAPSHOTS in container.hpp
+        inline bool share() {
+            _assert_level_0(!bulk_load_is_in());
+            return base_t::share();
+        };
+
+        // the index is copied as it is now, so clauses must not be appended since share()
+        inline void snapshot(const CnfClausesIndexedContainer& other) {
+            _assert_level_0(!bulk_load_is_in() && !other.bulk_load_is_in());
+            _assert_level_0(other.size_ == other.shared_size());
+            base_t::snapshot(other);
+        };
+
         template<typename... Literals>
         inline void append_clause_l(Literals... literals) {
             constexpr auto n = sizeof...(literals);
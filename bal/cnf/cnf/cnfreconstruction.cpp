@@ -0,0 +1,66 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include "cnfreconstruction.hpp"
+
+namespace bal {
+
+    // the last clause removed goes first since the clauses removed before it may only contain remaining variables
+    void CnfReconstructionStack::replay(const std::vector<literalid_t>& clauses, VariablesArray& values) {
+        literalid_t* const result = values.data();
+        size_t offset = clauses.size();
+        while (offset > 0) {
+            const clause_size_t clause_size = clauses[--offset];
+            offset -= clause_size;
+            const literalid_t* const literals = clauses.data() + offset;
+            bool b_satisfied = false;
+            for (auto i = 0; i < clause_size && !b_satisfied; i++) {
+                b_satisfied = literal_t__is_constant_1(literal_t__lookup(result, literals[i]));
+            };
+            if (!b_satisfied) {
+                result[literal_t__variable_id(literals[0])] = literal_t__constant(literal_t__is_unnegated(literals[0]));
+            };
+        };
+    };
+
+    void CnfReconstructionStack::reconstruct(const VariablesArray& model, VariablesArray& values) const {
+        values = model;
+        replay(clauses_, values);
+
+        // values before each mapping, the last one goes first;
+        // variables mapped to nothing are not in the formula anymore, any value does until replayed
+        std::vector<VariablesArray> inputs(steps_.size());
+        const VariablesArray* p_output = &values;
+        for (size_t s = steps_.size(); s > 0; s--) {
+            const VariablesArray& variables = steps_[s - 1].variables;
+            VariablesArray& input = inputs[s - 1];
+            input = variables;
+            for (variableid_t i = 0; i < input.size(); i++) {
+                if (literal_t__is_variable(variables.data()[i])) {
+                    input.data()[i] = literal_t__lookup(p_output->data(), variables.data()[i]);
+                } else if (literal_t__is_unassigned(variables.data()[i])) {
+                    input.data()[i] = LITERAL_CONST_0;
+                };
+            };
+            replay(steps_[s - 1].clauses, input);
+            p_output = &input;
+        };
+
+        // values set by replaying are carried over to the variables they are mapped to
+        for (size_t s = 0; s < steps_.size(); s++) {
+            const VariablesArray& variables = steps_[s].variables;
+            VariablesArray& output = s + 1 < steps_.size() ? inputs[s + 1] : values;
+            for (variableid_t i = 0; i < variables.size(); i++) {
+                if (literal_t__is_variable(variables.data()[i])) {
+                    output.data()[literal_t__variable_id(variables.data()[i])] =
+                        literal_t__substitute_literal(variables.data()[i], inputs[s].data()[i]);
+                };
+            };
+        };
+    };
+
+};
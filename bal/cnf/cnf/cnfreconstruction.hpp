@@ -0,0 +1,73 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfreconstruction_hpp
+#define cnfreconstruction_hpp
+
+#include <vector>
+#include "cnfclauses.hpp"
+#include "variablesarray.hpp"
+
+namespace bal {
+
+    // clauses removed from a formula such that a model of the rest may falsify them,
+    // i.e. by variable elimination and blocked clause elimination, together with
+    // the variable mappings of the processing that follows their removal;
+    // reconstruct() extends a model of the formula to satisfy the removed clauses as well
+    // each clause is recorded with the literal to set first, then the other literals, then its size;
+    // clauses are replayed in reverse order, a clause not satisfied sets its first literal
+    class CnfReconstructionStack {
+    private:
+        struct step_t {
+            // values of the variables before the mapping, see CnfOptimizer::update_variables
+            VariablesArray variables;
+            // clauses removed before the mapping, with variables as before it
+            std::vector<literalid_t> clauses;
+        };
+        std::vector<step_t> steps_;
+        // clauses removed since the last mapping
+        std::vector<literalid_t> clauses_;
+
+        static void replay(const std::vector<literalid_t>& clauses, VariablesArray& values);
+
+    public:
+        inline bool is_empty() const { return steps_.empty() && clauses_.empty(); };
+
+        inline void clear() {
+            steps_.clear();
+            clauses_.clear();
+        };
+
+        // records the clause of the literal and the other literals; the literal itself is skipped among them
+        inline void push(const literalid_t literal, const literalid_t* const literals, const clause_size_t literals_size) {
+            const size_t offset = clauses_.size();
+            clauses_.push_back(literal);
+            for (auto i = 0; i < literals_size; i++) {
+                if (literals[i] != literal) {
+                    clauses_.push_back(literals[i]);
+                };
+            };
+            clauses_.push_back((literalid_t)(clauses_.size() - offset));
+        };
+
+        // the variables of the formula are mapped as the values given
+        // nothing is recorded until there are clauses
+        inline void update(const VariablesArray& variables) {
+            if (!is_empty()) {
+                steps_.push_back({ variables, std::vector<literalid_t>() });
+                steps_.back().clauses.swap(clauses_);
+            };
+        };
+
+        // model - constant values of all variables of the formula as it is now
+        // values - receives the same values except those the removed clauses need changed
+        void reconstruct(const VariablesArray& model, VariablesArray& values) const;
+    };
+
+};
+
+#endif /* cnfreconstruction_hpp */
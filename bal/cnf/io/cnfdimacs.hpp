@@ -108,6 +108,8 @@ namespace bal {
                     assert(!is_header_read);
                     read_header(value);
                     is_header_read = true;
+                    // clauses are indexed at once after reading
+                    value.bulk_load_begin();
                 } else {
                     assert(is_header_read);
                     literals.clear();
@@ -126,11 +128,15 @@ namespace bal {
                     read_eol();
                     
                     assert(literals.size() <= CLAUSE_SIZE_MAX);
-                    value.append_clause(literals.data(), literals.size());
+                    value.bulk_load_append_clause(literals.data(), literals.size());
                 }
             };
             
             read_eof();
+            
+            if (value.bulk_load_is_in()) {
+                value.bulk_load_commit();
+            };
         };
     };
     
@@ -166,7 +172,7 @@ namespace bal {
         };
         
         virtual void write_clauses(const Cnf& value) {
-            for (auto it: value.clauses()) {
+            for (auto it: value.clauses_ordered()) {
                 print_clause(stream, _clauses_offset_item_clause(it), " 0\n");
             };
         };
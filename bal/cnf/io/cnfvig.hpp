@@ -191,7 +191,7 @@ namespace bal {
         virtual void compute_edges(const Cnf& value, const timestamp_t timestamp,
                                    edges_data_t& edges, unsigned& next_edge_id) {
             stream << std::dec;
-            for (auto it: value.clauses()) {
+            for (auto it: value.clauses_ordered()) {
                 compute_edge<false>(_clauses_offset_item_clause(it), timestamp, edges, next_edge_id);
             };
         };
@@ -0,0 +1,291 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include "cnfbatchevaluator.hpp"
+#include "cnfoptimizer.hpp"
+
+namespace bal {
+
+    constexpr unsigned CnfBatchEvaluator::LANES_SIZE;
+
+    // expands aggregated clauses into members, literals are negated where the member bitmap bit is 0
+    inline void CnfBatchEvaluator::build_members() {
+        members_.clear();
+        container_offset_t offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause)) {
+                const clause_size_t size = _clause_size(p_clause);
+                if (_clause_size_is_aggregated(size)) {
+                    const clause_flags_t flags = _clause_flags(p_clause);
+                    for (auto bitmap = 0; bitmap < (0x1 << size); bitmap++) {
+                        if ((flags & (0x1 << bitmap)) != 0) {
+                            members_.push_back(size);
+                            for (auto i = 0; i < size; i++) {
+                                members_.push_back(literal_t__negated_onlyif(_clause_literal(p_clause, i), (bitmap & (0x1 << i)) == 0));
+                            };
+                        };
+                    };
+                } else {
+                    members_.push_back(size);
+                    members_.insert(members_.end(), _clause_literals(p_clause), _clause_literals(p_clause) + size);
+                };
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        sort_members();
+
+        // occurrences are counted first, then placed into the range of each variable
+        const variables_size_t variables_size = cnf_.variables_size();
+        occurrences_offsets_.assign(variables_size + 1, 0);
+        for (uint32_t offset = 0; offset < members_.size(); offset += members_[offset] + 1) {
+            for (auto i = 1; i <= members_[offset]; i++) {
+                occurrences_offsets_[literal_t__variable_id(members_[offset + i]) + 1]++;
+            };
+        };
+        for (variableid_t i = 0; i < variables_size; i++) {
+            occurrences_offsets_[i + 1] += occurrences_offsets_[i];
+        };
+        occurrences_.resize(occurrences_offsets_[variables_size]);
+        std::vector<uint32_t> positions(occurrences_offsets_.begin(), occurrences_offsets_.end() - 1);
+        for (uint32_t offset = 0; offset < members_.size(); offset += members_[offset] + 1) {
+            for (auto i = 1; i <= members_[offset]; i++) {
+                occurrences_[positions[literal_t__variable_id(members_[offset + i])]++] = offset;
+            };
+        };
+    };
+
+    // orders members by their highest variable, then by the next highest one
+    // an encoding numbers variables in the order of its operations, so a member follows those
+    // its units are implied by, whatever the values; e.g. the clauses of the sum of an addition
+    // depend on its carry and come after the clauses of the carry, sharing the highest variable
+    inline void CnfBatchEvaluator::sort_members() {
+        // offset, highest variable and the next highest variable + 1, 0 if none, by member number
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> highest;
+        std::vector<uint32_t> next;
+        for (uint32_t offset = 0; offset < members_.size(); offset += members_[offset] + 1) {
+            uint32_t first = 0;
+            uint32_t second = 0;
+            for (auto i = 1; i <= members_[offset]; i++) {
+                const uint32_t variable = literal_t__variable_id(members_[offset + i]) + 1;
+                if (variable > first) {
+                    second = first;
+                    first = variable;
+                } else if (variable > second) {
+                    second = variable;
+                };
+            };
+            offsets.push_back(offset);
+            highest.push_back(first - 1);
+            next.push_back(second);
+        };
+
+        // stable counting sort by the next highest variable, then by the highest one
+        std::vector<uint32_t> order(offsets.size());
+        for (uint32_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        };
+        std::vector<uint32_t> sorted(offsets.size());
+        const auto sort_by = [&order, &sorted](const std::vector<uint32_t>& keys, const uint32_t keys_size) {
+            std::vector<uint32_t> positions(keys_size + 1, 0);
+            for (auto i: order) {
+                positions[keys[i] + 1]++;
+            };
+            for (uint32_t key = 0; key < keys_size; key++) {
+                positions[key + 1] += positions[key];
+            };
+            for (auto i: order) {
+                sorted[positions[keys[i]]++] = i;
+            };
+            order.swap(sorted);
+        };
+        sort_by(next, cnf_.variables_size() + 1);
+        sort_by(highest, cnf_.variables_size());
+
+        std::vector<literalid_t> members;
+        members.reserve(members_.size());
+        for (auto i: order) {
+            members.insert(members.end(), members_.begin() + offsets[i], members_.begin() + offsets[i] + members_[offsets[i]] + 1);
+        };
+        members_.swap(members);
+    };
+
+    inline void CnfBatchEvaluator::assign_literal(const literalid_t literal_id, const lanes_t lanes) {
+        const variableid_t variable_id = literal_t__variable_id(literal_id);
+        const lanes_t values = literal_t__is_unnegated(literal_id) ? lanes : 0;
+        conflicts_ |= known_[variable_id] & lanes & (values_[variable_id] ^ values);
+        const lanes_t assigned = lanes & ~known_[variable_id];
+        if (assigned != 0) {
+            known_[variable_id] |= assigned;
+            values_[variable_id] = (values_[variable_id] & ~assigned) | (values & assigned);
+            if (!changed_flags_[variable_id]) {
+                changed_flags_[variable_id] = true;
+                changed_.push_back(variable_id);
+            };
+            changed_offsets_[variable_id] = sweep_offset_;
+        };
+    };
+
+    // assigns the only literal not false in the lanes where the others are false
+    // the lanes where all literals are false are in conflict
+    inline void CnfBatchEvaluator::propagate_member(const literalid_t* const p_member) {
+        const clause_size_t size = p_member[0];
+        const literalid_t* const literals = p_member + 1;
+        lanes_t falsified[size + 1];
+        lanes_t satisfied = 0;
+        for (auto i = 0; i < size; i++) {
+            const variableid_t variable_id = literal_t__variable_id(literals[i]);
+            const lanes_t values = literal_t__is_unnegated(literals[i]) ? values_[variable_id] : ~values_[variable_id];
+            satisfied |= known_[variable_id] & values;
+            falsified[i] = known_[variable_id] & ~values;
+        };
+        const lanes_t lanes = lanes_ & ~conflicts_ & ~satisfied;
+        if (lanes == 0) {
+            return;
+        };
+
+        // falsified[i] becomes the lanes where the literals after i are all false
+        falsified[size] = ~(lanes_t)0;
+        for (auto i = size; i > 0; i--) {
+            falsified[i - 1] &= falsified[i];
+        };
+        conflicts_ |= lanes & falsified[0];
+        // preceding are the lanes where the literals before i are all false
+        lanes_t preceding = lanes & ~falsified[0];
+        for (auto i = 0; i < size && preceding != 0; i++) {
+            const variableid_t variable_id = literal_t__variable_id(literals[i]);
+            const lanes_t units = preceding & falsified[i + 1] & ~known_[variable_id];
+            if (units != 0) {
+                assign_literal(literals[i], units);
+                propagations_++;
+            };
+            const lanes_t values = literal_t__is_unnegated(literals[i]) ? values_[variable_id] : ~values_[variable_id];
+            preceding &= known_[variable_id] & ~values;
+        };
+    };
+
+    void CnfBatchEvaluator::reset(const unsigned lanes_size) {
+        _assert_level_0(lanes_size <= LANES_SIZE);
+        lanes_ = lanes_size == LANES_SIZE ? ~(lanes_t)0 : ((lanes_t)1 << lanes_size) - 1;
+        conflicts_ = 0;
+        known_.assign(cnf_.variables_size(), 0);
+        values_.assign(cnf_.variables_size(), 0);
+        changed_.clear();
+        changed_flags_.assign(cnf_.variables_size(), false);
+        changed_offsets_.assign(cnf_.variables_size(), 0);
+        sweep_offset_ = (uint32_t)members_.size();
+    };
+
+    void CnfBatchEvaluator::assign(const std::string& name, const VariablesArray& value, const unsigned lane) {
+        const VariablesArray& template_ = named_variables_.at(name);
+        _assert_level_0(lane < LANES_SIZE && template_.size() == value.size());
+        const lanes_t lanes = (lanes_t)1 << lane;
+        for (auto i = 0; i < template_.size(); i++) {
+            const literalid_t literal_id = template_.data()[i];
+            const literalid_t value_id = value.data()[i];
+            if (literal_t__is_constant(value_id)) {
+                if (literal_t__is_variable(literal_id)) {
+                    assign_literal(literal_t__negated_onlyif(literal_id, literal_t__is_constant_0(value_id)), lanes);
+                } else if (literal_id != value_id) {
+                    conflicts_ |= lanes;
+                };
+            };
+        };
+    };
+
+    bool CnfBatchEvaluator::execute() {
+        if (members_.empty() && clauses_size_ > 0) {
+            build_members();
+        };
+
+        // a single sweep sees all values assigned so far
+        for (auto variable_id: changed_) {
+            changed_flags_[variable_id] = false;
+        };
+        changed_.clear();
+        propagations_ = 0;
+        for (sweep_offset_ = 0; sweep_offset_ < members_.size(); sweep_offset_ += members_[sweep_offset_] + 1) {
+            propagate_member(members_.data() + sweep_offset_);
+        };
+        // members from the one a variable was changed by on have been swept since
+        while (!changed_.empty() && (conflicts_ & lanes_) != lanes_) {
+            const variableid_t variable_id = changed_.back();
+            changed_.pop_back();
+            changed_flags_[variable_id] = false;
+            const uint32_t changed_offset = changed_offsets_[variable_id];
+            for (auto i = occurrences_offsets_[variable_id];
+                 i < occurrences_offsets_[variable_id + 1] && occurrences_[i] < changed_offset; i++) {
+                propagate_member(members_.data() + occurrences_[i]);
+            };
+        };
+        return (conflicts_ & lanes_) == 0;
+    };
+
+    void CnfBatchEvaluator::get(const std::string& name, VariablesArray& value, const unsigned lane) const {
+        const VariablesArray& template_ = cnf_.get_named_variables().at(name);
+        _assert_level_0(lane < LANES_SIZE && template_.size() == value.size());
+        const lanes_t lanes = (lanes_t)1 << lane;
+        for (auto i = 0; i < template_.size(); i++) {
+            const literalid_t literal_id = template_.data()[i];
+            if (literal_t__is_variable(literal_id) && (known_[literal_t__variable_id(literal_id)] & lanes) != 0) {
+                const bool b_value = (values_[literal_t__variable_id(literal_id)] & lanes) != 0;
+                value.data()[i] = literal_t__constant(b_value != literal_t__is_negation(literal_id));
+            } else {
+                value.data()[i] = literal_id;
+            };
+        };
+    };
+
+    void CnfBatchEvaluator::get(VariablesArray& variables, const unsigned lane) const {
+        _assert_level_0(lane < LANES_SIZE && variables.size() == known_.size());
+        const lanes_t lanes = (lanes_t)1 << lane;
+        for (variableid_t i = 0; i < known_.size(); i++) {
+            if ((known_[i] & lanes) != 0) {
+                variables.data()[i] = literal_t__constant((values_[i] & lanes) != 0);
+            };
+        };
+    };
+
+    uint64_t evaluate_batch(Cnf& cnf,
+                            const char* parameter_name, const std::vector<VariablesArray>& parameter_values,
+                            const char* result_name, std::vector<VariablesArray>& result_values) {
+        _assert_level_0(parameter_values.size() <= CnfBatchEvaluator::LANES_SIZE);
+        const VariablesArray& result_template = cnf.get_named_variables().at(result_name);
+        CnfBatchEvaluator evaluator(cnf, (unsigned)parameter_values.size());
+        for (unsigned i = 0; i < parameter_values.size(); i++) {
+            evaluator.assign(parameter_name, parameter_values[i], i);
+        };
+        evaluator.execute();
+
+        uint64_t result = 0;
+        result_values.assign(parameter_values.size(), result_template);
+        for (unsigned i = 0; i < parameter_values.size(); i++) {
+            if ((evaluator.conflicts() & ((uint64_t)1 << i)) != 0) {
+                continue;
+            };
+            VariablesArray& value = result_values[i];
+            evaluator.get(result_name, value, i);
+            bool b_determined = true;
+            for (auto j = 0; b_determined && j < value.size(); j++) {
+                b_determined = literal_t__is_constant(value.data()[j]) || literal_t__is_constant(result_template.data()[j]);
+            };
+            if (!b_determined) {
+                VariablesArray variables(cnf.variables_size(), 1);
+                variables.assign_sequence();
+                evaluator.get(variables, i);
+                if (!evaluate(cnf, variables)) {
+                    continue;
+                };
+                variables.assign_template_into(result_template, value);
+            };
+            result |= (uint64_t)1 << i;
+        };
+        return result;
+    };
+
+};
@@ -0,0 +1,91 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfbatchevaluator_hpp
+#define cnfbatchevaluator_hpp
+
+#include <string>
+#include <vector>
+#include "cnfprocessor.hpp"
+#include "variablesarray.hpp"
+
+namespace bal {
+
+    // evaluates the formula for up to LANES_SIZE assignments at once by unit propagation
+    // values are bit-sliced: each binary variable has a word of its values, bit i ("lane") for assignment i,
+    // and a word of lanes its value is known in
+    // clause members, aggregated clauses expanded, are ordered topologically by their variables
+    // and swept once, then revisited through variable occurrences while values change;
+    // a variable changed during the sweep only revisits the members before the one it was changed by,
+    // so an encoding mostly settles in the sweep
+    // unlike CnfVariableEvaluator, neither equivalences nor resolution are used,
+    // so values derived by the full evaluation may remain undetermined
+    class CnfBatchEvaluator: public CnfProcessor {
+    public:
+        typedef uint64_t lanes_t;
+        static constexpr unsigned LANES_SIZE = 64;
+
+    private:
+        // each member is its size followed by its literals
+        std::vector<literalid_t> members_;
+        // offsets of members_ with each variable, occurrences_offsets_[i] is where those of variable i start
+        std::vector<uint32_t> occurrences_;
+        std::vector<uint32_t> occurrences_offsets_;
+        // variables whose values changed since their members were last visited
+        // and the offset of the member each one was last changed by, members_.size() outside the sweep
+        std::vector<variableid_t> changed_;
+        std::vector<bool> changed_flags_;
+        std::vector<uint32_t> changed_offsets_;
+        uint32_t sweep_offset_ = 0;
+
+        std::vector<lanes_t> known_;
+        std::vector<lanes_t> values_;
+        lanes_t lanes_ = 0;
+        lanes_t conflicts_ = 0;
+        uint64_t propagations_ = 0;
+
+        inline void build_members();
+        inline void sort_members();
+        inline void assign_literal(const literalid_t literal_id, const lanes_t lanes);
+        inline void propagate_member(const literalid_t* const p_member);
+
+    public:
+        CnfBatchEvaluator(Cnf& cnf, const unsigned lanes_size = LANES_SIZE): CnfProcessor(cnf) {
+            reset(lanes_size);
+        };
+
+        // unassigns all variables in all lanes
+        void reset(const unsigned lanes_size);
+
+        // value must match the named variable template; constants are assigned, anything else is skipped
+        // a value conflicting with the template or the values assigned already makes the lane a conflict
+        void assign(const std::string& name, const VariablesArray& value, const unsigned lane);
+
+        // returns false if any lane is in conflict
+        bool execute() override;
+
+        // values of the lanes in conflict are meaningless
+        inline lanes_t conflicts() const { return conflicts_; };
+        inline uint64_t propagations() const { return propagations_; };
+
+        // the named variable in the lane: constants where determined, the template literals otherwise
+        void get(const std::string& name, VariablesArray& value, const unsigned lane) const;
+        // assigns the variables determined in the lane, leaves the others as they are
+        void get(VariablesArray& variables, const unsigned lane) const;
+    };
+
+    // evaluates the result named variable for each of up to CnfBatchEvaluator::LANES_SIZE parameter values
+    // the lanes where unit propagation leaves the result undetermined are completed by evaluate
+    // starting from the values propagated, the results are the same as those of evaluate then
+    // returns lanes, i.e. bits by parameter value index, the formula is consistent with
+    uint64_t evaluate_batch(Cnf& cnf,
+                            const char* parameter_name, const std::vector<VariablesArray>& parameter_values,
+                            const char* result_name, std::vector<VariablesArray>& result_values);
+
+};
+
+#endif /* cnfbatchevaluator_hpp */
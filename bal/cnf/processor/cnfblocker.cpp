@@ -0,0 +1,238 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <iostream>
+#include "cnfblocker.hpp"
+
+namespace bal {
+
+    constexpr uint32_t CnfBlockedClauseEliminator::MEMBER_NOT_AGGREGATED;
+
+#define _member_offset(p_member) (p_member)[0]
+#define _member_bitmap(p_member) (p_member)[1]
+#define _member_size(p_member) (p_member)[2]
+#define _member_literals(p_member) ((p_member) + 3)
+#define _member_is_removed(p_member) (_member_offset(p_member) == CONTAINER_END)
+#define _members_next(members, m) (m) += _member_size((members).data() + (m)) + 3
+
+    // expands all clauses with the variable into member clauses
+    inline void CnfBlockedClauseEliminator::collect_clauses(const variableid_t variable_id) {
+        positives_.clear();
+        negatives_.clear();
+        positives_size_ = 0;
+        negatives_size_ = 0;
+
+        CnfProcessor::nonoptimizing_clauses_iterator_t iterator(clauses_index_, *this);
+        container_offset_t offset = iterator.first(variable_id);
+        while (offset != CONTAINER_END) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            const clause_size_t clause_size = _clause_size(p_clause);
+            clause_size_t index = 0;
+            while (_clause_variable(p_clause, index) != variable_id) {
+                index++;
+            };
+            if (_clause_size_is_aggregated(clause_size)) {
+                const uint16_t flags = _clause_flags(p_clause);
+                for (uint16_t bitmap = 0; bitmap < (0x1 << clause_size); bitmap++) {
+                    if ((flags & (0x1 << bitmap)) != 0) {
+                        const bool b_positive = ((bitmap >> index) & 1) != 0;
+                        std::vector<literalid_t>& members = b_positive ? positives_ : negatives_;
+                        members.push_back(offset);
+                        members.push_back(bitmap);
+                        members.push_back(clause_size);
+                        for (auto i = 0; i < clause_size; i++) {
+                            members.push_back(literal_t__negated_onlyif(_clause_literal(p_clause, i), ((bitmap >> i) & 1) == 0));
+                        };
+                        (b_positive ? positives_size_ : negatives_size_)++;
+                    };
+                };
+            } else {
+                const bool b_positive = literal_t__is_unnegated(_clause_literal(p_clause, index));
+                std::vector<literalid_t>& members = b_positive ? positives_ : negatives_;
+                members.push_back(offset);
+                members.push_back(MEMBER_NOT_AGGREGATED);
+                members.push_back(clause_size);
+                members.insert(members.end(), _clause_literals(p_clause), _clause_literals(p_clause) + clause_size);
+                (b_positive ? positives_size_ : negatives_size_)++;
+            };
+            offset = iterator.next();
+        };
+    };
+
+    // true if resolvents of the member on the literal with all remaining others are tautologies
+    inline bool CnfBlockedClauseEliminator::is_blocked(const literalid_t* const p_member, const literalid_t literal,
+                                                       const std::vector<literalid_t>& others) {
+        const literalid_t* const literals = _member_literals(p_member);
+        for (auto i = 0; i < _member_size(p_member); i++) {
+            literals_marked_[literals[i]] = true;
+        };
+
+        bool result = true;
+        for (size_t n = 0; n < others.size() && result; _members_next(others, n)) {
+            const literalid_t* const p_other = others.data() + n;
+            if (_member_is_removed(p_other)) {
+                continue;
+            };
+            resolution_effort_.spend();
+            const literalid_t* const other_literals = _member_literals(p_other);
+            bool b_tautology = false;
+            for (auto i = 0; i < _member_size(p_other) && !b_tautology; i++) {
+                b_tautology = !literal_t__is_same_variable(other_literals[i], literal) &&
+                              literals_marked_[literal_t__negated(other_literals[i])];
+            };
+            result = b_tautology;
+        };
+
+        for (auto i = 0; i < _member_size(p_member); i++) {
+            literals_marked_[literals[i]] = false;
+        };
+        return result;
+    };
+
+    // flags of an aggregated clause within the transaction bound may not be changed, the clause may be excluded only
+    inline bool CnfBlockedClauseEliminator::is_removable(const literalid_t* const p_member) const {
+        if (_member_bitmap(p_member) == MEMBER_NOT_AGGREGATED || !clauses_.transaction_offset_is_immutable(_member_offset(p_member))) {
+            return true;
+        };
+        return _clauses_offset_flags(clauses_data_, _member_offset(p_member)) == (0x1 << _member_bitmap(p_member));
+    };
+
+    // removes the member from the formula, queues variables of its other literals
+    // the member is recorded to be satisfied by its literal should a solution falsify it
+    inline void CnfBlockedClauseEliminator::remove_member(literalid_t* const p_member, const literalid_t literal) {
+        const literalid_t* const literals = _member_literals(p_member);
+        cnf_.reconstruction().push(literal, literals, _member_size(p_member));
+        for (auto i = 0; i < _member_size(p_member); i++) {
+            if (literals[i] != literal) {
+                queue_variable(literal_t__variable_id(literals[i]));
+            };
+        };
+        blocked_size_++;
+
+        const container_offset_t offset = _member_offset(p_member);
+        if (_member_bitmap(p_member) == MEMBER_NOT_AGGREGATED) {
+            clauses_.exclude(offset);
+        } else {
+            const uint16_t flags = _clauses_offset_flags(clauses_data_, offset) & ~(0x1 << _member_bitmap(p_member));
+            if (flags == 0) {
+                clauses_.exclude(offset);
+            } else {
+                _clause_flags_set(_clauses_offset_clause(clauses_data_, offset), flags);
+            };
+        };
+        _member_offset(p_member) = CONTAINER_END;
+    };
+
+    inline void CnfBlockedClauseEliminator::eliminate_pure_literal(std::vector<literalid_t>& members, const literalid_t literal) {
+        bool b_removed = true;
+        for (size_t m = 0; m < members.size(); _members_next(members, m)) {
+            if (is_removable(members.data() + m)) {
+                remove_member(members.data() + m, literal);
+            } else {
+                b_removed = false;
+            };
+        };
+        if (b_removed) {
+            pure_size_++;
+        };
+    };
+
+    // members removed already are left out of the remaining checks
+    inline void CnfBlockedClauseEliminator::eliminate_blocked_clauses(std::vector<literalid_t>& members, const literalid_t literal,
+                                                                      const std::vector<literalid_t>& others) {
+        for (size_t m = 0; m < members.size() && !resolution_effort_.is_exhausted(); _members_next(members, m)) {
+            literalid_t* const p_member = members.data() + m;
+            if (is_removable(p_member) && is_blocked(p_member, literal, others)) {
+                remove_member(p_member, literal);
+            };
+        };
+    };
+
+    inline void CnfBlockedClauseEliminator::queue_variable(const variableid_t variable_id) {
+        if (!variables_queued_[variable_id] && !variables_named_[variable_id]) {
+            variables_queued_[variable_id] = true;
+            queue_.push_back(variable_id);
+        };
+    };
+
+    processor_result_t CnfBlockedClauseEliminator::eliminate_clauses() {
+        const variables_size_t variables_size = variables_.size();
+
+        variables_named_.assign(variables_size, false);
+        for (auto vit = named_variables_.begin(); vit != named_variables_.end(); vit++) {
+            const literalid_t* const template_ = vit->second.data();
+            for (auto i = 0; i < vit->second.size(); i++) {
+                if (literal_t__is_variable(template_[i])) {
+                    variables_named_[literal_t__variable_id(template_[i])] = true;
+                };
+            };
+        };
+
+        literals_marked_.assign(variable_t__literal_id(variables_size), false);
+        variables_queued_.assign(variables_size, false);
+        for (variableid_t i = variables_size; i > 0; i--) {
+            queue_variable(i - 1);
+        };
+
+        // once out of budget, the remaining variables are left unchecked
+        resolution_effort_ = CnfEffort(get_cnf_effort_limits().resolvents);
+        while (!queue_.empty() && !resolution_effort_.is_exhausted()) {
+            const variableid_t variable_id = queue_.back();
+            queue_.pop_back();
+            variables_queued_[variable_id] = false;
+
+            collect_clauses(variable_id);
+            const literalid_t literal = variable_t__literal_id(variable_id);
+            if (positives_size_ + negatives_size_ == 0) {
+                continue;
+            } else if (negatives_size_ == 0) {
+                eliminate_pure_literal(positives_, literal);
+            } else if (positives_size_ == 0) {
+                eliminate_pure_literal(negatives_, literal_t__negated(literal));
+            } else if (!b_pure_only_ && positives_size_ + negatives_size_ <= CNF_BLOCKING_OCCURRENCES_MAX) {
+                eliminate_blocked_clauses(positives_, literal, negatives_);
+                eliminate_blocked_clauses(negatives_, literal_t__negated(literal), positives_);
+            };
+        };
+
+        return blocked_size_ > 0 ? erChangedV : erUndetermined;
+    };
+
+    bool CnfBlockedClauseEliminator::execute() {
+        return execute(true);
+    };
+
+    bool CnfBlockedClauseEliminator::execute(const bool b_reindex_variables) {
+        const variables_size_t original_variables_size = cnf_.variables_size();
+        const clauses_size_t original_clauses_size = cnf_.clauses_size();
+
+        build_clauses_index();
+        eliminate_clauses();
+
+        const variableid_t new_variables_size = update_variables(b_reindex_variables);
+        rebuild_clauses<CnfOptimizer, &CnfOptimizer::_update_clause_variables>(this, false);
+        cnf_.named_variables_update(variables_);
+        if (b_reindex_variables && new_variables_size != cnf_.variables_size()) {
+            set_variables_size(new_variables_size);
+        };
+
+        std::cout << "Blocked: " << std::dec << blocked_size_ << " clause(s), " << pure_size_ << " pure literal(s), ";
+        std::cout << "(" << original_variables_size << ", " << original_clauses_size << ") -> ";
+        std::cout << "(" << cnf_.variables_size() << ", " << cnf_.clauses_size() << ")";
+        if (!b_pure_only_) {
+            std::cout << ", ";
+            resolution_effort_.print(std::cout, "resolvent(s)");
+        };
+        std::cout << std::endl;
+
+        clauses_index_.reset(0, 0);
+        processed_offset_ = 0; // to match state of the indexes
+
+        // removing clauses does not make the formula unsatisfiable
+        return true;
+    };
+};
@@ -0,0 +1,93 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfblocker_hpp
+#define cnfblocker_hpp
+
+#include "cnfoptimizer.hpp"
+
+namespace bal {
+
+    // blocked clause and pure literal elimination
+    // a clause is blocked on its literal if all resolvents with the clauses of the opposite literal
+    // are tautologies; a literal is pure if its opposite does not occur at all,
+    // the clause may be removed in both cases without changing satisfiability;
+    // members of aggregated clauses are checked individually,
+    // the clause loses the flag of a removed member, it is excluded once no members remain;
+    // variables are checked in turn, variables of the removed clauses are queued again;
+    // literals of named variables never block, so a solution of the processed formula
+    // gives their values as it is; removed clauses are recorded in the reconstruction stack
+    // of the formula with the blocking literal first, the same one variable elimination uses
+    // clauses with a variable are taken from the occurrence lists of clauses_index_,
+    // the SimpleLinkedListsIndex of CnfProcessor, excluded clauses are skipped by the iterator
+    class CnfBlockedClauseEliminator: public CnfOptimizer {
+    protected:
+        // occurrences limit of a variable checked for blocked clauses
+        static constexpr uint32_t CNF_BLOCKING_OCCURRENCES_MAX = 64;
+
+        static constexpr uint32_t MEMBER_NOT_AGGREGATED = UINT32_MAX;
+
+    private:
+        // pure literals only, without blocked clauses
+        bool b_pure_only_;
+        std::vector<bool> variables_named_;
+        clauses_size_t blocked_size_ = 0;
+        variables_size_t pure_size_ = 0;
+
+        // variables to check, each one is queued once at a time
+        std::vector<variableid_t> queue_;
+        std::vector<bool> variables_queued_;
+
+        // member clauses with the variable unnegated and negated
+        // each member is the clause offset, the member bitmap or MEMBER_NOT_AGGREGATED,
+        // its size and the literals including the variable itself
+        std::vector<literalid_t> positives_;
+        std::vector<literalid_t> negatives_;
+        uint32_t positives_size_ = 0;
+        uint32_t negatives_size_ = 0;
+
+        // literals of the member being checked, by literal id
+        std::vector<bool> literals_marked_;
+
+    private:
+        inline void collect_clauses(const variableid_t variable_id);
+        inline bool is_blocked(const literalid_t* const p_member, const literalid_t literal, const std::vector<literalid_t>& others);
+        inline bool is_removable(const literalid_t* const p_member) const;
+        inline void remove_member(literalid_t* const p_member, const literalid_t literal);
+        inline void eliminate_pure_literal(std::vector<literalid_t>& members, const literalid_t literal);
+        inline void eliminate_blocked_clauses(std::vector<literalid_t>& members, const literalid_t literal, const std::vector<literalid_t>& others);
+        inline void queue_variable(const variableid_t variable_id);
+
+    protected:
+        processor_result_t eliminate_clauses();
+
+    public:
+        CnfBlockedClauseEliminator(Cnf& cnf, VariablesArray& variables, const bool b_pure_only = false):
+            CnfOptimizer(cnf, variables), b_pure_only_(b_pure_only) {};
+
+        bool execute() override;
+        virtual bool execute(const bool b_reindex_variables);
+
+        inline clauses_size_t blocked_size() const { return blocked_size_; };
+        inline variables_size_t pure_size() const { return pure_size_; };
+    };
+
+    inline bool eliminate_pure_literals(Cnf& cnf, const bool b_reindex_variables) {
+        VariablesArray variables(cnf.variables_size(), 1);
+        variables.assign_sequence();
+        return CnfBlockedClauseEliminator(cnf, variables, true).execute(b_reindex_variables);
+    };
+
+    inline bool eliminate_blocked_clauses(Cnf& cnf, const bool b_reindex_variables) {
+        VariablesArray variables(cnf.variables_size(), 1);
+        variables.assign_sequence();
+        return CnfBlockedClauseEliminator(cnf, variables).execute(b_reindex_variables);
+    };
+
+};
+
+#endif /* cnfblocker_hpp */
@@ -0,0 +1,298 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include "cnfcomponents.hpp"
+
+namespace bal {
+
+#ifdef CNF_TRACE
+    extern Ref<CnfTracer> p_tracer_;
+#endif
+
+    unsigned cnf_threads_ = 0;
+
+    void set_cnf_threads(const unsigned threads) {
+        cnf_threads_ = threads;
+    };
+
+    unsigned get_cnf_threads() {
+        return cnf_threads_;
+    };
+
+    // calls f(literals, size) for each clause member not satisfied by the variables values
+    // with literals resolved and constants omitted; returns false if a member is falsified
+    template<typename F>
+    inline bool CnfComponentOptimizer::for_each_member(const uint32_t* const p_clause, const F& f) const {
+        const literalid_t* const variables = variables_.data();
+        const clause_size_t clause_size = _clause_size(p_clause);
+        const bool b_aggregated = _clause_size_is_aggregated(clause_size);
+        const clause_flags_t flags = b_aggregated ? _clause_flags(p_clause) : 1;
+        literalid_t literals[clause_size];
+        for (uint32_t bits = 0; bits < 16; bits++) {
+            if ((flags & (1 << bits)) == 0) {
+                continue;
+            };
+            clause_size_t size = 0;
+            bool b_satisfied = false;
+            for (auto i = 0; i < clause_size && !b_satisfied; i++) {
+                literalid_t literal_id = _clause_literal(p_clause, i);
+                if (b_aggregated) {
+                    // literals of an aggregated clause are stored unnegated
+                    literal_id = literal_t__negated_onlyif(literal_id, (bits & (1 << i)) == 0);
+                };
+                literal_id = literal_t::resolve(variables, literal_id);
+                if (literal_t__is_constant_1(literal_id)) {
+                    b_satisfied = true;
+                } else if (literal_t__is_variable(literal_id)) {
+                    literals[size++] = literal_id;
+                };
+            };
+            if (!b_satisfied) {
+                if (size == 0) {
+                    return false;
+                };
+                f(literals, size);
+            };
+        };
+        return true;
+    };
+
+    // returns false if there are less than two groups or a clause is falsified
+    inline bool CnfComponentOptimizer::split_components(const unsigned threads_size) {
+        const variables_size_t variables_size = variables_.size();
+        std::vector<variableid_t> parents(variables_size);
+        for (variableid_t i = 0; i < variables_size; i++) {
+            parents[i] = i;
+        };
+        const auto find_root = [&parents](variableid_t variable_id) {
+            while (parents[variable_id] != variable_id) {
+                variable_id = parents[variable_id] = parents[parents[variable_id]];
+            };
+            return variable_id;
+        };
+
+        // members are counted by the variable of their first literal
+        std::vector<bool> b_used(variables_size, false);
+        std::vector<size_t> weights(variables_size, 0);
+        container_offset_t offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause) && !for_each_member(p_clause, [&](const literalid_t* const literals, const clause_size_t size) {
+                const variableid_t root = find_root(literal_t__variable_id(literals[0]));
+                weights[literal_t__variable_id(literals[0])]++;
+                for (auto i = 0; i < size; i++) {
+                    b_used[literal_t__variable_id(literals[i])] = true;
+                    parents[find_root(literal_t__variable_id(literals[i]))] = root;
+                };
+            })) {
+                // the conflict is left to the optimizer
+                return false;
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+
+        std::vector<std::pair<size_t, variableid_t>> components;
+        for (variableid_t i = 0; i < variables_size; i++) {
+            const variableid_t root = find_root(i);
+            if (root != i) {
+                weights[root] += weights[i];
+            };
+        };
+        for (variableid_t i = 0; i < variables_size; i++) {
+            if (parents[i] == i && weights[i] > 0) {
+                components.push_back({weights[i], i});
+            };
+        };
+        components_size_ = components.size();
+        const size_t groups_size = std::min<size_t>(threads_size, components_size_);
+        if (groups_size < 2) {
+            return false;
+        };
+
+        // the heaviest components first, each to the lightest group
+        std::sort(components.begin(), components.end(), std::greater<std::pair<size_t, variableid_t>>());
+        std::vector<size_t> loads(groups_size, 0);
+        std::vector<uint32_t> groups(variables_size, 0);
+        for (auto it: components) {
+            const size_t group = std::min_element(loads.begin(), loads.end()) - loads.begin();
+            loads[group] += it.first;
+            groups[it.second] = (uint32_t)group;
+        };
+
+        // group variables are numbered in the original order so that references still go to lower variables
+        groups_variables_.assign(groups_size, std::vector<variableid_t>());
+        groups_members_.assign(groups_size, std::vector<literalid_t>());
+        groups_named_.assign(groups_size, std::vector<variableid_t>());
+        // named variables are kept by the group optimizers as they are by this one
+        std::vector<bool> b_named(variables_size, false);
+        for (auto it = named_variables_.begin(); it != named_variables_.end(); it++) {
+            for (auto i = 0; i < it->second.size(); i++) {
+                const literalid_t literal_id = it->second.data()[i];
+                if (literal_t__is_variable(literal_id) && literal_t__variable_id(literal_id) < variables_size) {
+                    b_named[literal_t__variable_id(literal_id)] = true;
+                };
+            };
+        };
+        std::vector<variableid_t> locals(variables_size, 0);
+        for (variableid_t i = 0; i < variables_size; i++) {
+            if (b_used[i]) {
+                const uint32_t group = groups[find_root(i)];
+                std::vector<variableid_t>& group_variables = groups_variables_[group];
+                locals[i] = (variableid_t)group_variables.size();
+                if (b_named[i]) {
+                    groups_named_[group].push_back(locals[i]);
+                };
+                group_variables.push_back(i);
+            };
+        };
+        offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause)) {
+                for_each_member(p_clause, [&](const literalid_t* const literals, const clause_size_t size) {
+                    std::vector<literalid_t>& members = groups_members_[groups[find_root(literal_t__variable_id(literals[0]))]];
+                    members.push_back(size);
+                    for (auto i = 0; i < size; i++) {
+                        const variableid_t local = locals[literal_t__variable_id(literals[i])];
+                        members.push_back(literal_t__negated_onlyif(variable_t__literal_id(local), literal_t__is_negation(literals[i])));
+                    };
+                });
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        return true;
+    };
+
+    // assigns values of group variables and replaces clauses of the formula by those of the groups
+    inline bool CnfComponentOptimizer::merge_groups(std::vector<Cnf>& formulas, std::vector<VariablesArray>& variables) {
+        literalid_t* const values = variables_.data();
+        for (auto i = 0; i < formulas.size(); i++) {
+            const std::vector<variableid_t>& group_variables = groups_variables_[i];
+            const literalid_t* const group_values = variables[i].data();
+            for (variableid_t j = 0; j < group_variables.size(); j++) {
+                const literalid_t value = group_values[j];
+                if (literal_t__is_constant(value)) {
+                    values[group_variables[j]] = value;
+                } else if (literal_t__is_variable(value) && literal_t__variable_id(value) != j) {
+                    values[group_variables[j]] = literal_t__negated_onlyif(variable_t__literal_id(group_variables[literal_t__variable_id(value)]),
+                                                                           literal_t__is_negation(value));
+                };
+                // unused variables are left to update_variables
+            };
+        };
+
+        // the order of literals is kept because group variables are in the original order
+        std::vector<uint32_t> clause;
+        clear_clauses();
+        clauses_.bulk_load_begin();
+        for (auto i = 0; i < formulas.size(); i++) {
+            const std::vector<variableid_t>& group_variables = groups_variables_[i];
+            for (auto it: formulas[i].clauses()) {
+                const uint32_t* const p_clause = _clauses_offset_item_clause(it);
+                if (!_clause_is_included(p_clause)) {
+                    continue;
+                };
+                clause.resize(_clause_memory_size(p_clause));
+                _clause_header(clause.data()) = _clause_header(p_clause);
+                for (auto j = 0; j < _clause_size(p_clause); j++) {
+                    const literalid_t literal_id = _clause_literal(p_clause, j);
+                    _clause_literal(clause.data(), j) = literal_t__negated_onlyif(variable_t__literal_id(group_variables[literal_t__variable_id(literal_id)]),
+                                                                                  literal_t__is_negation(literal_id));
+                };
+                clauses_.bulk_load_append(clause.data());
+            };
+        };
+        clauses_.bulk_load_commit();
+        return true;
+    };
+
+    bool CnfComponentOptimizer::execute(const bool b_reindex_variables, const FormulaProcessingMode mode) {
+        const unsigned threads_size = threads_ == 0 ? std::thread::hardware_concurrency() : threads_;
+        bool b_traced = false;
+#ifdef CNF_TRACE
+        // tracers refer to clauses of a single formula
+        b_traced = (p_tracer_ != nullptr);
+#endif
+        if (mode == fpmUnoptimized || b_traced || threads_size < 2 || !split_components(threads_size)) {
+            return CnfOptimizer::execute(b_reindex_variables, mode);
+        };
+
+        const clauses_size_t original_clauses_size = cnf_.clauses_size();
+        const size_t groups_size = groups_variables_.size();
+        std::vector<Cnf> formulas(groups_size);
+        std::vector<VariablesArray> variables;
+        variables.reserve(groups_size);
+        for (auto i = 0; i < groups_size; i++) {
+            variables.emplace_back((container_size_t)groups_variables_[i].size(), 1);
+            variables.back().assign_sequence();
+        };
+
+        std::vector<uint8_t> results(groups_size, false);
+        std::atomic<size_t> next(0);
+        auto worker = [&]() {
+            size_t i;
+            while ((i = next.fetch_add(1)) < groups_size) {
+                Cnf& formula = formulas[i];
+                const std::vector<literalid_t>& members = groups_members_[i];
+                formula.set_build_threads(1);
+                formula.resize((variables_size_t)groups_variables_[i].size(), 0);
+                formula.bulk_load_begin();
+                for (size_t j = 0; j < members.size(); j += members[j] + 1) {
+                    formula.bulk_load_append_clause(members.data() + j + 1, members[j]);
+                };
+                formula.bulk_load_commit();
+                const std::vector<variableid_t>& named = groups_named_[i];
+                VariablesArray named_variables((container_size_t)named.size(), 1);
+                for (auto j = 0; j < named.size(); j++) {
+                    named_variables.data()[j] = variable_t__literal_id(named[j]);
+                };
+                formula.add_named_variable("named", named_variables);
+
+                CnfComponentOptimizer optimizer(formula, variables[i]);
+                optimizer.b_silent_ = true;
+                results[i] = optimizer.base_execute(false, mode);
+            };
+        };
+        std::vector<std::thread> threads;
+        for (auto i = 1; i < std::min<size_t>(threads_size, groups_size); i++) {
+            threads.emplace_back(worker);
+        };
+        worker();
+        for (auto& thread: threads) {
+            thread.join();
+        };
+
+        // the formula is unchanged if any group is found unsatisfiable
+        // group optimizers are silent and number variables their own way, the conflict is found again
+        for (auto i = 0; i < groups_size; i++) {
+            if (!results[i]) {
+                return CnfOptimizer::execute(b_reindex_variables, mode);
+            };
+        };
+        merge_groups(formulas, variables);
+
+        build_clauses_index();
+        const variableid_t new_variables_size = update_variables(b_reindex_variables);
+        rebuild_clauses<CnfOptimizer, &CnfOptimizer::_update_clause_variables>(this, false);
+        cnf_.named_variables_update(variables_);
+        if (b_reindex_variables && new_variables_size != cnf_.variables_size()) {
+            set_variables_size(new_variables_size);
+        };
+        clauses_index_.reset(0, 0);
+        processed_offset_ = 0; // to match state of the indexes
+
+        std::cout << "Components: " << std::dec << components_size_ << " component(s) in ";
+        std::cout << groups_size << " group(s)" << std::endl;
+        print_optimized(original_clauses_size);
+        return true;
+    };
+
+};
@@ -0,0 +1,61 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfcomponents_hpp
+#define cnfcomponents_hpp
+
+#include "cnfoptimizer.hpp"
+
+namespace bal {
+
+    // number of threads processing groups of components at once, 0 for all hardware threads
+    // 1 processes the formula by a single optimizer
+    void set_cnf_threads(const unsigned threads);
+    unsigned get_cnf_threads();
+
+    // processes connected components of the variable incidence graph independently
+    // clauses are resolved against the variables array, satisfied clause members are skipped
+    // so that assigned variables do not connect components;
+    // components are distributed over groups balanced by the number of clause members,
+    // each group is a separate formula processed by its own optimizer on its own thread;
+    // results are merged back into the formula, variables are reindexed afterwards
+    // falls back to a single optimizer for a single group, unoptimized mode or when tracing;
+    // if a group is found unsatisfiable, the formula is processed again by a single optimizer
+    // which reports the conflict in terms of the formula variables
+    class CnfComponentOptimizer: public CnfOptimizer {
+    private:
+        // number of groups processed at once, 0 for all hardware threads
+        unsigned threads_ = get_cnf_threads();
+
+        size_t components_size_ = 0;
+        // for each group, its variables in ascending order, its clause members,
+        // each is its size followed by literals of the group variables, and its named variables
+        std::vector<std::vector<variableid_t>> groups_variables_;
+        std::vector<std::vector<literalid_t>> groups_members_;
+        std::vector<std::vector<variableid_t>> groups_named_;
+
+        template<typename F>
+        inline bool for_each_member(const uint32_t* const p_clause, const F& f) const;
+        inline bool split_components(const unsigned threads_size);
+        inline bool merge_groups(std::vector<Cnf>& formulas, std::vector<VariablesArray>& variables);
+
+    public:
+        CnfComponentOptimizer(Cnf& cnf, VariablesArray& variables): CnfOptimizer(cnf, variables) {};
+
+        inline void set_threads(const unsigned value) { threads_ = value; };
+
+        bool execute(const bool b_reindex_variables, const FormulaProcessingMode mode) override;
+    };
+
+    inline bool process(Cnf& cnf, VariablesArray& variables,
+                        const bool b_reindex_variables, const FormulaProcessingMode mode) {
+        return bal::CnfComponentOptimizer(cnf, variables).execute(b_reindex_variables, mode);
+    };
+
+};
+
+#endif /* cnfcomponents_hpp */
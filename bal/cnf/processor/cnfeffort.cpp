@@ -0,0 +1,40 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <chrono>
+#include "cnfeffort.hpp"
+
+namespace bal {
+
+    constexpr uint64_t CnfEffort::TIME_CHECK_PERIOD;
+
+    CnfEffortLimits effort_limits_;
+    std::chrono::steady_clock::time_point effort_deadline_;
+
+    void set_cnf_effort_limits(const CnfEffortLimits& limits) {
+        effort_limits_ = limits;
+        effort_deadline_ = std::chrono::steady_clock::now() + std::chrono::seconds(limits.seconds);
+    };
+
+    const CnfEffortLimits& get_cnf_effort_limits() {
+        return effort_limits_;
+    };
+
+    bool is_cnf_effort_time_out() {
+        return effort_limits_.seconds != 0 && std::chrono::steady_clock::now() >= effort_deadline_;
+    };
+
+    void CnfEffort::print(std::ostream& stream, const char* const units_name) const {
+        stream << std::dec << spent_ << " " << units_name;
+        if (b_time_out_) {
+            stream << " (out of time)";
+        } else if (b_exhausted_) {
+            stream << " (out of budget)";
+        };
+    };
+
+};
@@ -0,0 +1,73 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfeffort_hpp
+#define cnfeffort_hpp
+
+#include <cstdint>
+#include <ostream>
+
+namespace bal {
+
+    // effort budgets of the processing techniques, 0 means unlimited
+    //   propagations - literals assigned while probing
+    //   resolvents - resolvents produced by the optimizer and by variable elimination
+    //   subsumptions - long clauses checked for subsumption and self-subsuming resolution
+    //   seconds - wall-clock time for all techniques together, counted from set_cnf_effort_limits
+    // each run of a technique gets its budget anew; once the budget or the time runs out
+    // the technique stops where the formula is consistent and the rest of processing goes on
+    typedef struct CnfEffortLimits {
+        uint64_t propagations = 0;
+        uint64_t resolvents = 0;
+        uint64_t subsumptions = 0;
+        uint32_t seconds = 0;
+    } CnfEffortLimits;
+
+    // starts the clock for the time limit
+    void set_cnf_effort_limits(const CnfEffortLimits& limits);
+    const CnfEffortLimits& get_cnf_effort_limits();
+    bool is_cnf_effort_time_out();
+
+    // effort spent by a single run of a technique against one of the budgets
+    class CnfEffort {
+    private:
+        // the time is checked once per so many units spent
+        static constexpr uint64_t TIME_CHECK_PERIOD = 1 << 10;
+
+        uint64_t budget_;
+        uint64_t spent_ = 0;
+        bool b_exhausted_ = false;
+        bool b_time_out_ = false;
+
+    public:
+        // default_budget applies unless the budget is specified
+        CnfEffort(const uint64_t budget = 0, const uint64_t default_budget = 0):
+            budget_(budget == 0 ? default_budget : budget) {
+            b_exhausted_ = b_time_out_ = is_cnf_effort_time_out();
+        };
+
+        // records the units spent; returns false once the budget or the time has run out
+        inline bool spend(const uint64_t units = 1) {
+            const uint64_t spent = spent_ + units;
+            if (spent / TIME_CHECK_PERIOD != spent_ / TIME_CHECK_PERIOD && !b_time_out_) {
+                b_time_out_ = is_cnf_effort_time_out();
+            };
+            spent_ = spent;
+            b_exhausted_ = b_time_out_ || (budget_ != 0 && spent_ >= budget_);
+            return !b_exhausted_;
+        };
+
+        inline bool is_exhausted() const { return b_exhausted_; };
+        inline uint64_t spent() const { return spent_; };
+
+        // the units spent with their name and the reason the technique stopped if it did
+        void print(std::ostream& stream, const char* const units_name) const;
+    };
+
+};
+
+#endif /* cnfeffort_hpp */
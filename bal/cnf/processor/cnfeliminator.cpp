@@ -0,0 +1,328 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <algorithm>
+#include <iostream>
+#include "cnfeliminator.hpp"
+
+namespace bal {
+
+    constexpr uint32_t CnfVariableEliminator::COST_UNDEFINED;
+
+    // index of the variable within the clause
+    inline clause_size_t clause_variable_index(const uint32_t* const p_clause, const variableid_t variable_id) {
+        for (auto i = 0; i < _clause_size(p_clause); i++) {
+            if (_clause_variable(p_clause, i) == variable_id) {
+                return i;
+            };
+        };
+        _assert_level_0(false);
+        return CLAUSE_SIZE_MAX;
+    };
+
+    // number of resolution pairs, COST_UNDEFINED if the variable may not be eliminated
+    inline uint32_t CnfVariableEliminator::evaluate_cost(const variableid_t variable_id) {
+        if (variables_eliminated_[variable_id] || variables_protected_[variable_id]) {
+            return COST_UNDEFINED;
+        };
+
+        // flags of the aggregated clause members with the literal negated and unnegated
+        constexpr uint16_t map0[4] = { 0x5555, 0x3333, 0x0F0F, 0x00FF };
+        constexpr uint16_t map1[4] = { 0xAAAA, 0xCCCC, 0xF0F0, 0xFF00 };
+
+        uint32_t positives_size = 0;
+        uint32_t negatives_size = 0;
+        CnfProcessor::nonoptimizing_clauses_iterator_t iterator(clauses_index_, *this);
+        container_offset_t offset = iterator.first(variable_id);
+        while (offset != CONTAINER_END) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            const clause_size_t index = clause_variable_index(p_clause, variable_id);
+            if (_clause_is_aggregated(p_clause)) {
+                positives_size += get_cardinality_uint16(_clause_flags(p_clause) & map1[index]);
+                negatives_size += get_cardinality_uint16(_clause_flags(p_clause) & map0[index]);
+            } else if (literal_t__is_unnegated(_clause_literal(p_clause, index))) {
+                positives_size++;
+            } else {
+                negatives_size++;
+            };
+            offset = iterator.next();
+        };
+
+        if (positives_size + negatives_size == 0) {
+            // not used
+            return COST_UNDEFINED;
+        } else if (positives_size != 0 && negatives_size != 0 &&
+                   positives_size + negatives_size > CNF_ELIMINATION_OCCURRENCES_MAX) {
+            return COST_UNDEFINED;
+        } else {
+            return positives_size * negatives_size;
+        };
+    };
+
+    // expands all clauses with the variable into member clauses without it
+    inline void CnfVariableEliminator::collect_clauses(const variableid_t variable_id) {
+        positives_.clear();
+        negatives_.clear();
+        positives_size_ = 0;
+        negatives_size_ = 0;
+        positive_offsets_.clear();
+        negative_offsets_.clear();
+        offsets_.clear();
+
+        CnfProcessor::nonoptimizing_clauses_iterator_t iterator(clauses_index_, *this);
+        container_offset_t offset = iterator.first(variable_id);
+        while (offset != CONTAINER_END) {
+            offsets_.push_back(offset);
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            const clause_size_t clause_size = _clause_size(p_clause);
+            const clause_size_t index = clause_variable_index(p_clause, variable_id);
+            if (_clause_size_is_aggregated(clause_size)) {
+                // members with the unnegated literal remain when it is 0, with the negated one when it is 1
+                for (literalid_t value = LITERAL_CONST_0; value <= LITERAL_CONST_1; value++) {
+                    std::vector<literalid_t>& members = (value == LITERAL_CONST_0) ? positives_ : negatives_;
+                    std::vector<container_offset_t>& members_offsets = (value == LITERAL_CONST_0) ? positive_offsets_ : negative_offsets_;
+                    uint32_t& members_size = (value == LITERAL_CONST_0) ? positives_size_ : negatives_size_;
+                    uint16_t flags = _clause_flags(p_clause);
+                    ca_flags_reduce(flags, index, value);
+                    for (uint16_t bitmap = 0; flags != 0; bitmap++, flags >>= 1) {
+                        if ((flags & 1) != 0) {
+                            members.push_back(clause_size - 1);
+                            clause_size_t k = 0;
+                            for (auto i = 0; i < clause_size; i++) {
+                                if (i != index) {
+                                    members.push_back(literal_t__negated_onlyif(_clause_literal(p_clause, i), ((bitmap >> k) & 1) == 0));
+                                    k++;
+                                };
+                            };
+                            members_offsets.push_back(offset);
+                            members_size++;
+                        };
+                    };
+                };
+            } else {
+                const bool b_positive = literal_t__is_unnegated(_clause_literal(p_clause, index));
+                std::vector<literalid_t>& members = b_positive ? positives_ : negatives_;
+                members.push_back(clause_size - 1);
+                for (auto i = 0; i < clause_size; i++) {
+                    if (i != index) {
+                        members.push_back(_clause_literal(p_clause, i));
+                    };
+                };
+                (b_positive ? positive_offsets_ : negative_offsets_).push_back(offset);
+                (b_positive ? positives_size_ : negatives_size_)++;
+            };
+            offset = iterator.next();
+        };
+    };
+
+    // makes all non tautological resolvents of the collected clauses
+    // returns erUndetermined if the limits are exceeded, erConflict if a resolvent is empty
+    inline processor_result_t CnfVariableEliminator::resolve_clauses() {
+        resolvents_.clear();
+        const uint32_t resolvents_size_max = positives_size_ + negatives_size_ + clauses_growth_;
+        uint32_t resolvents_size = 0;
+
+        for (size_t p = 0, p_index = 0; p < positives_.size(); p += positives_[p] + 1, p_index++) {
+            const literalid_t* const p_literals = positives_.data() + p + 1;
+            const clause_size_t p_size = positives_[p];
+            for (size_t n = 0, n_index = 0; n < negatives_.size(); n += negatives_[n] + 1, n_index++) {
+                const literalid_t* const n_literals = negatives_.data() + n + 1;
+                const clause_size_t n_size = negatives_[n];
+
+                // literals are ordered by variable; merge them
+                const size_t resolvent_offset = resolvents_.size();
+                resolvents_.push_back(0);
+                clause_size_t i = 0;
+                clause_size_t j = 0;
+                bool b_tautology = false;
+                while (i < p_size || j < n_size) {
+                    literalid_t literal;
+                    if (j == n_size || (i < p_size && literal_t__variable_id(p_literals[i]) < literal_t__variable_id(n_literals[j]))) {
+                        literal = p_literals[i++];
+                    } else if (i == p_size || literal_t__variable_id(n_literals[j]) < literal_t__variable_id(p_literals[i])) {
+                        literal = n_literals[j++];
+                    } else if (p_literals[i] == n_literals[j]) {
+                        literal = p_literals[i++];
+                        j++;
+                    } else {
+                        b_tautology = true;
+                        break;
+                    };
+                    resolvents_.push_back(literal);
+                };
+
+                if (b_tautology) {
+                    resolvents_.resize(resolvent_offset);
+                } else {
+                    const clause_size_t resolvent_size = (clause_size_t)(resolvents_.size() - resolvent_offset - 1);
+                    if (resolvent_size == 0) {
+                        conflict_offsets_[0] = positive_offsets_[p_index];
+                        conflict_offsets_[1] = negative_offsets_[n_index];
+                        return erConflict;
+                    };
+                    resolution_effort_.spend();
+                    if (resolvent_size > CNF_ELIMINATION_RESOLVENT_SIZE_MAX || ++resolvents_size > resolvents_size_max) {
+                        return erUndetermined;
+                    };
+                    resolvents_[resolvent_offset] = resolvent_size;
+                };
+            };
+        };
+
+        return erChangedV;
+    };
+
+    // records clauses of the less frequent literal followed by the opposite unit, see CnfReconstructionStack
+    inline void CnfVariableEliminator::record_clauses(const variableid_t variable_id) {
+        const bool b_positive = positives_size_ <= negatives_size_;
+        const std::vector<literalid_t>& members = b_positive ? positives_ : negatives_;
+        const literalid_t literal = variable_t__literal_id_negated_onlyif(variable_id, !b_positive);
+        CnfReconstructionStack& reconstruction = cnf_.reconstruction();
+        
+        for (size_t m = 0; m < members.size(); m += members[m] + 1) {
+            reconstruction.push(literal, members.data() + m + 1, members[m]);
+        };
+        reconstruction.push(literal_t__negated(literal), nullptr, 0);
+    };
+
+    inline void CnfVariableEliminator::touch_variable(const variableid_t variable_id) {
+        if (!variables_touched_[variable_id] && !variables_eliminated_[variable_id]) {
+            variables_touched_[variable_id] = true;
+            touched_.push_back(variable_id);
+        };
+    };
+
+    // replaces the clauses with the variable by their resolvents unless there are too many
+    inline processor_result_t CnfVariableEliminator::eliminate_variable(const variableid_t variable_id) {
+        collect_clauses(variable_id);
+        const processor_result_t result = resolve_clauses();
+        if (result == erConflict) {
+            __print_conflict(variables_.data(), _clauses_offset_clause(clauses_data_, conflict_offsets_[0]),
+                             _clauses_offset_clause(clauses_data_, conflict_offsets_[1]), variable_id);
+        };
+        if (result != erChangedV) {
+            return result;
+        };
+
+        record_clauses(variable_id);
+        variables_eliminated_[variable_id] = true;
+        eliminated_size_++;
+
+        for (auto i = 0; i < offsets_.size(); i++) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offsets_[i]);
+            for (auto j = 0; j < _clause_size(p_clause); j++) {
+                touch_variable(_clause_variable(p_clause, j));
+            };
+            clauses_.exclude(offsets_[i]);
+        };
+
+        // an aggregated resolvent may be merged into an existing clause
+        // which does not need indexing since it has the same variables
+        for (size_t r = 0; r < resolvents_.size(); r += resolvents_[r] + 1) {
+            const container_offset_t offset = clauses_size_;
+            clauses_.append_clause(resolvents_.data() + r + 1, resolvents_[r]);
+            if (clauses_size_ != offset) {
+                const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+                for (auto i = 0; i < _clause_size(p_clause); i++) {
+                    clauses_index_.append(_clause_variable(p_clause, i), offset);
+                };
+            };
+        };
+
+        return erChangedV;
+    };
+
+    processor_result_t CnfVariableEliminator::eliminate_variables() {
+        const variables_size_t variables_size = variables_.size();
+
+        variables_protected_.assign(variables_size, false);
+        for (auto vit = named_variables_.begin(); vit != named_variables_.end(); vit++) {
+            if (std::find(protected_names_.begin(), protected_names_.end(), vit->first) == protected_names_.end()) {
+                continue;
+            };
+            const literalid_t* const template_ = vit->second.data();
+            for (auto i = 0; i < vit->second.size(); i++) {
+                if (literal_t__is_variable(template_[i])) {
+                    variables_protected_[literal_t__variable_id(template_[i])] = true;
+                };
+            };
+        };
+
+        variables_eliminated_.assign(variables_size, false);
+        variables_touched_.assign(variables_size, false);
+        costs_.assign(variables_size, COST_UNDEFINED);
+        for (variableid_t i = 0; i < variables_size; i++) {
+            costs_[i] = evaluate_cost(i);
+            if (costs_[i] != COST_UNDEFINED) {
+                candidates_.push(candidate_t(costs_[i], i));
+            };
+        };
+
+        // once out of budget, the remaining candidates are left in the formula
+        resolution_effort_ = CnfEffort(get_cnf_effort_limits().resolvents);
+        while (!candidates_.empty() && !resolution_effort_.is_exhausted()) {
+            const candidate_t candidate = candidates_.top();
+            candidates_.pop();
+            const variableid_t variable_id = candidate.second;
+            if (candidate.first != costs_[variable_id]) {
+                continue;
+            };
+
+            // the variable is tried again only if its clauses change
+            costs_[variable_id] = COST_UNDEFINED;
+            const processor_result_t result = eliminate_variable(variable_id);
+            if (result == erConflict) {
+                return result;
+            } else if (result == erChangedV) {
+                for (auto i = 0; i < touched_.size(); i++) {
+                    const variableid_t touched_id = touched_[i];
+                    variables_touched_[touched_id] = false;
+                    costs_[touched_id] = evaluate_cost(touched_id);
+                    if (costs_[touched_id] != COST_UNDEFINED) {
+                        candidates_.push(candidate_t(costs_[touched_id], touched_id));
+                    };
+                };
+                touched_.clear();
+            };
+        };
+
+        return eliminated_size_ > 0 ? erChangedV : erUndetermined;
+    };
+
+    bool CnfVariableEliminator::execute() {
+        return execute(true);
+    };
+
+    // the formula is left partially processed if it is found unsatisfiable
+    bool CnfVariableEliminator::execute(const bool b_reindex_variables) {
+        const variables_size_t original_variables_size = cnf_.variables_size();
+        const clauses_size_t original_clauses_size = cnf_.clauses_size();
+
+        build_clauses_index();
+        bool result = (eliminate_variables() != erConflict);
+
+        if (result) {
+            const variableid_t new_variables_size = update_variables(b_reindex_variables);
+            rebuild_clauses<CnfOptimizer, &CnfOptimizer::_update_clause_variables>(this, false);
+            cnf_.named_variables_update(variables_);
+            if (b_reindex_variables && new_variables_size != cnf_.variables_size()) {
+                set_variables_size(new_variables_size);
+            };
+
+            std::cout << "Eliminated: " << std::dec << eliminated_size_ << " variable(s), ";
+            std::cout << "(" << original_variables_size << ", " << original_clauses_size << ") -> ";
+            std::cout << "(" << cnf_.variables_size() << ", " << cnf_.clauses_size() << "), ";
+            resolution_effort_.print(std::cout, "resolvent(s)");
+            std::cout << std::endl;
+        };
+
+        clauses_index_.reset(0, 0);
+        processed_offset_ = 0; // to match state of the indexes
+
+        return result;
+    };
+};
@@ -0,0 +1,99 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfeliminator_hpp
+#define cnfeliminator_hpp
+
+#include <queue>
+#include <string>
+#include <vector>
+#include "cnfoptimizer.hpp"
+
+namespace bal {
+
+    // bounded variable elimination by clause distribution
+    // all clauses with the variable are replaced by all non tautological resolvents on it
+    // provided that the formula does not grow (or grows by clauses_growth at most)
+    // and resolvents are not too long;
+    // variables are tried in the order of the fewest resolution pairs first,
+    // variables of the changed clauses are queued again after each elimination;
+    // members of aggregated clauses are resolved individually
+    // bits of the named variables listed are never eliminated, so a solution of the processed formula
+    // gives their values as it is; clauses of the eliminated variables are recorded
+    // in the reconstruction stack of the formula, which gives values of the others, see CnfReconstructionStack
+    class CnfVariableEliminator: public CnfOptimizer {
+    protected:
+        // resolution pairs and resolvents limits
+        static constexpr uint32_t CNF_ELIMINATION_OCCURRENCES_MAX = 64;
+        static constexpr clause_size_t CNF_ELIMINATION_RESOLVENT_SIZE_MAX = 20;
+
+        static constexpr uint32_t COST_UNDEFINED = UINT32_MAX;
+
+    private:
+        // number of clauses a single elimination may add to the formula
+        uint32_t clauses_growth_;
+        // names of the named variables whose bits are kept
+        std::vector<std::string> protected_names_;
+        std::vector<bool> variables_protected_;
+        std::vector<bool> variables_eliminated_;
+        variables_size_t eliminated_size_ = 0;
+
+        // candidates ordered by the number of resolution pairs
+        // entries with a cost different from costs_ are obsolete
+        typedef std::pair<uint32_t, variableid_t> candidate_t;
+        std::priority_queue<candidate_t, std::vector<candidate_t>, std::greater<candidate_t>> candidates_;
+        std::vector<uint32_t> costs_;
+
+        // variables of the clauses changed by the last elimination
+        std::vector<variableid_t> touched_;
+        std::vector<bool> variables_touched_;
+
+        // member clauses with the variable, the variable itself is omitted
+        // each clause is its size followed by the literals
+        std::vector<literalid_t> positives_;
+        std::vector<literalid_t> negatives_;
+        uint32_t positives_size_ = 0;
+        uint32_t negatives_size_ = 0;
+        // offsets of the clauses each member is taken from
+        std::vector<container_offset_t> positive_offsets_;
+        std::vector<container_offset_t> negative_offsets_;
+        std::vector<literalid_t> resolvents_;
+        std::vector<container_offset_t> offsets_;
+        // clauses of the members whose resolvent is empty
+        container_offset_t conflict_offsets_[2];
+
+    private:
+        inline uint32_t evaluate_cost(const variableid_t variable_id);
+        inline void collect_clauses(const variableid_t variable_id);
+        inline processor_result_t resolve_clauses();
+        inline void record_clauses(const variableid_t variable_id);
+        inline processor_result_t eliminate_variable(const variableid_t variable_id);
+        inline void touch_variable(const variableid_t variable_id);
+
+    protected:
+        processor_result_t eliminate_variables();
+
+    public:
+        CnfVariableEliminator(Cnf& cnf, VariablesArray& variables, const std::vector<std::string>& protected_names,
+                              const uint32_t clauses_growth = 0):
+            CnfOptimizer(cnf, variables), clauses_growth_(clauses_growth), protected_names_(protected_names) {};
+
+        bool execute() override;
+        virtual bool execute(const bool b_reindex_variables);
+
+        inline variables_size_t eliminated_size() const { return eliminated_size_; };
+    };
+
+    inline bool eliminate_variables(Cnf& cnf, const bool b_reindex_variables, const std::vector<std::string>& protected_names) {
+        VariablesArray variables(cnf.variables_size(), 1);
+        variables.assign_sequence();
+        return CnfVariableEliminator(cnf, variables, protected_names).execute(b_reindex_variables);
+    };
+
+};
+
+#endif /* cnfeliminator_hpp */
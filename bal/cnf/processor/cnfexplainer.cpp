@@ -0,0 +1,135 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <algorithm>
+#include "cnfexplainer.hpp"
+#include "cnfeffort.hpp"
+#include "cnfpropagator.hpp"
+
+namespace bal {
+
+    constexpr uint64_t CnfConflictExplainer::CNF_EXPLAIN_EVALUATIONS_MAX;
+
+    // returns true if unit propagation of the assignment reaches a conflict, core receives its reasons
+    inline bool CnfConflictExplainer::propagate(std::vector<variableid_t>& core) {
+        VariablesArray variables(variables_);
+        CnfUnitPropagator propagator(variables, clauses_data_);
+        bool result = true;
+        container_offset_t offset = 0;
+        while (result && offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause)) {
+                result = propagator.append(offset);
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        result = result && propagator.propagate();
+        return !result && propagator.explain(core);
+    };
+
+    // assigns the core variables in the range in addition to those assigned to the optimizer already
+    // returns false if the assignment conflicts with the formula
+    inline bool CnfConflictExplainer::assign(CnfIncrementalOptimizer& optimizer,
+                                             const std::vector<variableid_t>::const_iterator begin,
+                                             const std::vector<variableid_t>::const_iterator end) {
+        VariablesArray variables(variables_.size(), 1);
+        variables.assign_sequence();
+        for (auto it = begin; it != end; it++) {
+            variables.data()[*it] = variables_.data()[*it];
+        };
+        return optimizer.assign(variables);
+    };
+
+    // evaluates the optimized formula with the core variables assigned only, then rolls the assignment back
+    // an unsatisfiable formula conflicts with any core
+    inline bool CnfConflictExplainer::is_conflict(CnfIncrementalOptimizer& optimizer, const bool b_satisfiable,
+                                                  const std::vector<variableid_t>& core) {
+        evaluations_++;
+        if (!b_satisfiable) {
+            return true;
+        };
+        const bool result = !assign(optimizer, core.begin(), core.end());
+        optimizer.rollback();
+        return result;
+    };
+
+    // leaves out chunks of the core while the rest still conflicts; returns false once out of effort
+    // the chunks before i are kept within the pass, they stay assigned while the chunks after them are tested
+    inline bool CnfConflictExplainer::reduce(CnfIncrementalOptimizer& optimizer, const bool b_satisfiable,
+                                             std::vector<variableid_t>& core) {
+        if (!b_satisfiable) {
+            evaluations_++;
+            core.clear();
+            return true;
+        };
+        CnfEffort effort(0, CNF_EXPLAIN_EVALUATIONS_MAX);
+        for (size_t chunk_size = core.size(); chunk_size > 0; chunk_size >>= 1) {
+            size_t i = 0;
+            while (i < core.size()) {
+                if (!effort.spend()) {
+                    if (optimizer.transaction_is_in()) {
+                        optimizer.rollback();
+                    };
+                    return false;
+                };
+                const size_t chunk_end = std::min(i + chunk_size, core.size());
+                evaluations_++;
+                optimizer.savepoint();
+                const bool b_conflict = !assign(optimizer, core.begin() + chunk_end, core.end());
+                optimizer.rollback();
+                if (b_conflict) {
+                    core.erase(core.begin() + i, core.begin() + chunk_end);
+                } else if (assign(optimizer, core.begin() + i, core.begin() + chunk_end)) {
+                    i = chunk_end;
+                } else {
+                    // the chunks kept conflict on their own, as would any of the candidates left in the pass
+                    core.resize(chunk_end);
+                    i = chunk_end;
+                };
+            };
+            if (optimizer.transaction_is_in()) {
+                optimizer.rollback();
+            };
+        };
+        return true;
+    };
+
+    bool CnfConflictExplainer::execute() {
+        std::vector<variableid_t> core;
+        b_propagated_ = propagate(core);
+        if (!b_propagated_) {
+            for (variableid_t i = 0; i < variables_.size(); i++) {
+                if (literal_t__is_constant(variables_.data()[i])) {
+                    core.push_back(i);
+                };
+            };
+            // the formula as loaded is kept, its copy is optimized
+            Cnf formula;
+            formula.snapshot(cnf_);
+            VariablesArray variables(formula.variables_size(), 1);
+            variables.assign_sequence();
+            CnfIncrementalOptimizer optimizer(formula, variables);
+            const bool b_satisfiable = optimizer.execute();
+            if (!is_conflict(optimizer, b_satisfiable, core)) {
+                return false;
+            };
+            reduce(optimizer, b_satisfiable, core);
+        };
+
+        std::vector<bool> b_core(variables_.size(), false);
+        for (auto variable_id: core) {
+            b_core[variable_id] = true;
+        };
+        for (variableid_t i = 0; i < variables_.size(); i++) {
+            if (!b_core[i]) {
+                variables_.data()[i] = variable_t__literal_id(i);
+            };
+        };
+        return true;
+    };
+
+};
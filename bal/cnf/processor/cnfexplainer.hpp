@@ -0,0 +1,69 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfexplainer_hpp
+#define cnfexplainer_hpp
+
+#include <vector>
+#include "cnfoptimizer.hpp"
+#include "variablesarray.hpp"
+
+namespace bal {
+
+    // CONFLICT EXPLANATION
+    // finds a part of the assigned variables, the core, which conflicts with the formula on its own
+    //   unit propagation records the original clause implying each value;
+    //   the conflict is walked back through these reasons to the assigned variables behind it
+    //   if unit propagation does not reach a conflict, the optimizer decides instead:
+    //   chunks of the core are left out in turn while the rest still conflicts,
+    //   the chunks are halved down to single variables;
+    //   a copy of the formula is optimized once, then assigned incrementally: within a pass,
+    //   the chunks kept so far stay assigned and the rest of the core is assigned under a savepoint,
+    //   which is rolled back for the next chunk
+    // the core is not necessarily minimal; the evaluations are limited, the core found so far is kept then
+    // the formula is not changed
+    class CnfConflictExplainer: public CnfProcessor {
+    protected:
+        // effort limit: number of evaluations while reducing the core
+        static constexpr uint64_t CNF_EXPLAIN_EVALUATIONS_MAX = 1 << 12;
+
+    private:
+        // constants are the assignment; receives the core with the other variables unassigned
+        VariablesArray& variables_;
+        bool b_propagated_ = false;
+        uint64_t evaluations_ = 0;
+
+        inline bool propagate(std::vector<variableid_t>& core);
+        inline bool assign(CnfIncrementalOptimizer& optimizer,
+                           const std::vector<variableid_t>::const_iterator begin,
+                           const std::vector<variableid_t>::const_iterator end);
+        inline bool is_conflict(CnfIncrementalOptimizer& optimizer, const bool b_satisfiable,
+                                const std::vector<variableid_t>& core);
+        inline bool reduce(CnfIncrementalOptimizer& optimizer, const bool b_satisfiable,
+                           std::vector<variableid_t>& core);
+
+    public:
+        // variables must have a constant or refer to itself for each variable
+        CnfConflictExplainer(Cnf& cnf, VariablesArray& variables): CnfProcessor(cnf), variables_(variables) {
+            _assert_level_0(variables.size() == cnf.variables_size());
+        };
+
+        // returns false if the assignment does not conflict with the formula, the variables are unchanged then
+        bool execute() override;
+
+        // true if the core has been found by unit propagation
+        inline bool is_propagated() const { return b_propagated_; };
+        inline uint64_t evaluations() const { return evaluations_; };
+    };
+
+    inline bool explain_conflict(Cnf& cnf, VariablesArray& variables) {
+        return CnfConflictExplainer(cnf, variables).execute();
+    };
+
+};
+
+#endif /* cnfexplainer_hpp */
@@ -0,0 +1,375 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <algorithm>
+#include <iostream>
+#include "cnfgaussian.hpp"
+
+namespace bal {
+
+    // resolves literals of the clause, returns false unless all of them are distinct variables
+    inline bool resolve_clause_literals(const literalid_t* const variables, const uint32_t* const p_clause, literalid_t* const literals) {
+        const clause_size_t size = _clause_size(p_clause);
+        for (auto i = 0; i < size; i++) {
+            literals[i] = literal_t::resolve(variables, _clause_literal(p_clause, i));
+            if (!literal_t__is_variable(literals[i])) {
+                return false;
+            };
+            for (auto j = 0; j < i; j++) {
+                if (literal_t__is_same_variable(literals[i], literals[j])) {
+                    return false;
+                };
+            };
+        };
+        return true;
+    };
+
+    // patterns - bit b is set if there is a clause with literal i unnegated iff bit i of b is set
+    // a clause excludes the assignment with variable i equal to 0 iff bit i of b is set;
+    // if all patterns of the same parity are present, the XOR of variables is known
+    inline void CnfGaussianEliminator::append_xor(const literalid_t* const literals, const clause_size_t size, const uint32_t patterns[]) {
+        bool b_complete[2] = {true, true};
+        for (uint32_t b = 0; b < (1 << size); b++) {
+            if ((patterns[b >> 5] & (1u << (b & 31))) == 0) {
+                b_complete[__builtin_popcount(b) & 1] = false;
+            };
+        };
+        if (b_complete[0] == b_complete[1]) {
+            // either not an XOR or a conflict which is left to the optimizer
+            return;
+        };
+        xors_.push_back(size);
+        xors_.push_back((size + (b_complete[1] ? 1 : 0) + 1) & 1);
+        for (auto i = 0; i < size; i++) {
+            xors_.push_back(literal_t__variable_id(literals[i]));
+        };
+        xors_size_++;
+    };
+
+    inline void CnfGaussianEliminator::recover_xors() {
+        const literalid_t* const variables = variables_.data();
+        literalid_t literals[CNF_XOR_SIZE_MAX];
+        uint32_t patterns[(1 << CNF_XOR_SIZE_MAX) >> 5];
+
+        // unaggregated candidates with literals sorted, each is its size followed by literals
+        constexpr size_t candidate_size = CNF_XOR_SIZE_MAX + 1;
+        std::vector<literalid_t> candidates;
+
+        container_offset_t offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            const clause_size_t size = _clause_size(p_clause);
+            if (_clause_is_included(p_clause) && size > 1 && size <= CNF_XOR_SIZE_MAX &&
+                resolve_clause_literals(variables, p_clause, literals)) {
+                if (_clause_size_is_aggregated(size)) {
+                    // literals are stored unnegated, resolved ones may be negated
+                    uint32_t negations = 0;
+                    for (auto i = 0; i < size; i++) {
+                        if (literal_t__is_negation(literals[i])) {
+                            negations |= 1 << i;
+                            literal_t__unnegate(literals[i]);
+                        };
+                    };
+                    const clause_flags_t flags = _clause_flags(p_clause);
+                    patterns[0] = 0;
+                    for (uint32_t b = 0; b < (1 << size); b++) {
+                        if (flags & (1 << b)) {
+                            patterns[0] |= 1 << (b ^ negations);
+                        };
+                    };
+                    append_xor(literals, size, patterns);
+                } else {
+                    std::sort(literals, literals + size);
+                    candidates.push_back(size);
+                    candidates.insert(candidates.end(), literals, literals + size);
+                    candidates.resize(candidates.size() + CNF_XOR_SIZE_MAX - size, 0);
+                };
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+
+        // group candidates by variables
+        std::vector<uint32_t> order(candidates.size() / candidate_size);
+        for (auto i = 0; i < order.size(); i++) {
+            order[i] = i;
+        };
+        const literalid_t* const p_candidates = candidates.data();
+        const auto compare_variables = [p_candidates](const uint32_t lhs, const uint32_t rhs) {
+            const literalid_t* const p_lhs = p_candidates + lhs * candidate_size;
+            const literalid_t* const p_rhs = p_candidates + rhs * candidate_size;
+            if (p_lhs[0] != p_rhs[0]) {
+                return p_lhs[0] < p_rhs[0];
+            };
+            for (auto i = 1; i < candidate_size; i++) {
+                if ((p_lhs[i] | 1) != (p_rhs[i] | 1)) {
+                    return (p_lhs[i] | 1) < (p_rhs[i] | 1);
+                };
+            };
+            return false;
+        };
+        std::sort(order.begin(), order.end(), compare_variables);
+
+        for (auto i = 0; i < order.size();) {
+            const literalid_t* const p_first = p_candidates + order[i] * candidate_size;
+            const clause_size_t size = p_first[0];
+            std::fill(patterns, patterns + ((1 << size) + 31) / 32, 0);
+            auto j = i;
+            for (; j < order.size() && !compare_variables(order[i], order[j]); j++) {
+                const literalid_t* const p_literals = p_candidates + order[j] * candidate_size + 1;
+                uint32_t b = 0;
+                for (auto k = 0; k < size; k++) {
+                    if (literal_t__is_unnegated(p_literals[k])) {
+                        b |= 1 << k;
+                    };
+                };
+                patterns[b >> 5] |= 1u << (b & 31);
+            };
+            // 2^(size - 1) clauses at least
+            if (j - i >= (1 << (size - 1))) {
+                append_xor(p_first + 1, size, patterns);
+            };
+            i = j;
+        };
+    };
+
+    // rows - XORs of the component; columns - variables of the component, sorted
+    inline bool CnfGaussianEliminator::eliminate_component(const std::vector<size_t>& rows, std::vector<uint32_t>& columns) {
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+        const size_t rows_size = rows.size();
+        const size_t columns_size = columns.size();
+        // the parity is the last column
+        const size_t words_size = (columns_size + 1 + 63) >> 6;
+        if (rows_size < 2 || rows_size * words_size > CNF_GAUSS_MATRIX_WORDS_MAX) {
+            return true;
+        };
+
+        std::vector<uint64_t> matrix(rows_size * words_size, 0);
+        const auto set_bit = [&matrix, words_size](const size_t row, const size_t column) {
+            matrix[row * words_size + (column >> 6)] ^= (uint64_t)1 << (column & 63);
+        };
+        for (auto i = 0; i < rows_size; i++) {
+            const uint32_t* const p_xor = xors_.data() + rows[i];
+            for (auto j = 0; j < p_xor[0]; j++) {
+                set_bit(i, std::lower_bound(columns.begin(), columns.end(), p_xor[j + 2]) - columns.begin());
+            };
+            if (p_xor[1]) {
+                set_bit(i, columns_size);
+            };
+        };
+
+        // Gauss-Jordan elimination; rows below rank are zero left of the column,
+        // so the pivot row is XORed from the word of the column on
+        std::vector<uint32_t> pivots;
+        for (size_t column = 0; column < columns_size && pivots.size() < rows_size && !operation_effort_.is_exhausted(); column++) {
+            const size_t word = column >> 6;
+            const uint64_t bit = (uint64_t)1 << (column & 63);
+            const size_t rank = pivots.size();
+            size_t row = rank;
+            while (row < rows_size && (matrix[row * words_size + word] & bit) == 0) {
+                row++;
+            };
+            if (row == rows_size) {
+                continue;
+            };
+            uint64_t* const p_pivot = matrix.data() + rank * words_size;
+            std::swap_ranges(p_pivot, p_pivot + words_size, matrix.data() + row * words_size);
+            for (size_t i = 0; i < rows_size; i++) {
+                uint64_t* const p_row = matrix.data() + i * words_size;
+                if (i != rank && (p_row[word] & bit) != 0) {
+                    for (size_t k = word; k < words_size; k++) {
+                        p_row[k] ^= p_pivot[k];
+                    };
+                    operation_effort_.spend(words_size - word);
+                };
+            };
+            pivots.push_back(column);
+        };
+
+        // each row is a valid XOR even if the elimination is incomplete
+        const size_t parity_word = columns_size >> 6;
+        const uint64_t parity_bit = (uint64_t)1 << (columns_size & 63);
+        uint32_t row_columns[CNF_XOR_APPEND_SIZE_MAX + 1];
+        for (size_t i = 0; i < rows_size; i++) {
+            const uint64_t* const p_row = matrix.data() + i * words_size;
+            const bool parity = (p_row[parity_word] & parity_bit) != 0;
+            clause_size_t size = 0;
+            for (size_t k = 0; k < words_size && size <= CNF_XOR_APPEND_SIZE_MAX; k++) {
+                uint64_t word = p_row[k] & (k == parity_word ? ~parity_bit : ~(uint64_t)0);
+                while (word != 0 && size <= CNF_XOR_APPEND_SIZE_MAX) {
+                    row_columns[size++] = (uint32_t)(k << 6) + __builtin_ctzll(word);
+                    word &= word - 1;
+                };
+            };
+            if (size == 0) {
+                if (parity) {
+                    return false;
+                };
+            } else if (size == 1) {
+                assignments_.push_back({variable_t__literal_id(columns[row_columns[0]]), literal_t__constant(parity)});
+            } else if (size == 2) {
+                assignments_.push_back({variable_t__literal_id(columns[row_columns[0]]),
+                    literal_t__negated_onlyif(variable_t__literal_id(columns[row_columns[1]]), parity)});
+            } else if (size <= CNF_XOR_APPEND_SIZE_MAX) {
+                derived_.push_back(size);
+                derived_.push_back(parity);
+                for (auto j = 0; j < size; j++) {
+                    derived_.push_back(columns[row_columns[j]]);
+                };
+            };
+        };
+
+        // pivot rows which are the same except pivots make equivalent pivots
+        std::vector<uint64_t> tails(matrix.begin(), matrix.begin() + pivots.size() * words_size);
+        for (size_t i = 0; i < pivots.size(); i++) {
+            tails[i * words_size + (pivots[i] >> 6)] &= ~((uint64_t)1 << (pivots[i] & 63));
+            tails[i * words_size + parity_word] &= ~parity_bit;
+        };
+        std::vector<uint32_t> order(pivots.size());
+        for (auto i = 0; i < order.size(); i++) {
+            order[i] = i;
+        };
+        const uint64_t* const p_tails = tails.data();
+        const auto compare_tails = [p_tails, words_size](const uint32_t lhs, const uint32_t rhs) {
+            return std::lexicographical_compare(p_tails + lhs * words_size, p_tails + (lhs + 1) * words_size,
+                                                p_tails + rhs * words_size, p_tails + (rhs + 1) * words_size);
+        };
+        std::sort(order.begin(), order.end(), compare_tails);
+        for (size_t i = 1; i < order.size(); i++) {
+            if (!compare_tails(order[i - 1], order[i])) {
+                const bool parity = ((matrix[order[i - 1] * words_size + parity_word] ^ matrix[order[i] * words_size + parity_word]) & parity_bit) != 0;
+                assignments_.push_back({variable_t__literal_id(columns[pivots[order[i]]]),
+                    literal_t__negated_onlyif(variable_t__literal_id(columns[pivots[order[i - 1]]]), parity)});
+            };
+        };
+        return true;
+    };
+
+    // makes the literal equal to the value, a constant or a literal
+    // the higher variable references the lower one
+    // returns false if they turn out to be different
+    inline bool CnfGaussianEliminator::assign_equivalent(const literalid_t literal_id, const literalid_t value) {
+        literalid_t* const variables = variables_.data();
+        literalid_t literal = literal_t::resolve_compress(variables, literal_id);
+        literalid_t other = literal_t::resolve_compress(variables, value);
+        if (!literal_t__is_variable(literal)) {
+            std::swap(literal, other);
+        };
+        if (!literal_t__is_variable(literal)) {
+            return literal == other;
+        } else if (literal_t__is_same_variable(literal, other)) {
+            return literal == other;
+        } else if (!literal_t__is_variable(other)) {
+            variables[literal_t__variable_id(literal)] = literal_t__negated_onlyif(other, literal_t__is_negation(literal));
+            units_size_++;
+        } else if (literal > other) {
+            variables[literal_t__variable_id(literal)] = literal_t__negated_onlyif(other, literal_t__is_negation(literal));
+            equivalent_size_++;
+        } else {
+            variables[literal_t__variable_id(other)] = literal_t__negated_onlyif(literal, literal_t__is_negation(other));
+            equivalent_size_++;
+        };
+        return true;
+    };
+
+    // appends derived XORs as aggregated clauses unless all their members are present
+    inline void CnfGaussianEliminator::append_derived() {
+        for (size_t i = 0; i < derived_.size(); i += derived_[i] + 2) {
+            const clause_size_t size = derived_[i];
+            uint32_t clause[_clause_size_memory_size(CNF_XOR_APPEND_SIZE_MAX)];
+            for (auto j = 0; j < size; j++) {
+                clause[j + 1] = variable_t__literal_id(derived_[i + j + 2]);
+            };
+            std::sort(clause + 1, clause + size + 1);
+            // members excluding assignments of the other parity, see append_xor
+            clause_flags_t flags = 0;
+            for (uint32_t b = 0; b < (1 << size); b++) {
+                if (((size + __builtin_popcount(b) + 1) & 1) == derived_[i + 1]) {
+                    flags |= 1 << b;
+                };
+            };
+            _clause_header_set(clause, flags, size);
+
+            const container_offset_t offset = clauses_.find(clause);
+            if (offset == CONTAINER_END || !_clauses_offset_is_included(clauses_data_, offset) ||
+                (_clauses_offset_flags(clauses_data_, offset) & flags) != flags) {
+                Cnf::insertion_point_t insertion_point;
+                __insertion_point_t_init(insertion_point);
+                clauses_.append<false>(clause, insertion_point);
+                appended_size_++;
+            };
+        };
+    };
+
+    bool CnfGaussianEliminator::eliminate_xors() {
+        operation_effort_ = CnfEffort(0, CNF_GAUSS_OPERATIONS_MAX);
+        recover_xors();
+
+        // components of XORs sharing variables
+        std::vector<uint32_t> parents(variables_.size());
+        for (auto i = 0; i < parents.size(); i++) {
+            parents[i] = i;
+        };
+        const auto find_root = [&parents](uint32_t variable_id) {
+            while (parents[variable_id] != variable_id) {
+                variable_id = parents[variable_id] = parents[parents[variable_id]];
+            };
+            return variable_id;
+        };
+        std::vector<std::pair<uint32_t, size_t>> rows;
+        for (size_t i = 0; i < xors_.size(); i += xors_[i] + 2) {
+            const uint32_t root = find_root(xors_[i + 2]);
+            for (auto j = 1; j < xors_[i]; j++) {
+                parents[find_root(xors_[i + j + 2])] = root;
+            };
+        };
+        for (size_t i = 0; i < xors_.size(); i += xors_[i] + 2) {
+            rows.push_back({find_root(xors_[i + 2]), i});
+        };
+        std::sort(rows.begin(), rows.end());
+
+        std::vector<size_t> component;
+        std::vector<uint32_t> columns;
+        for (size_t i = 0; i < rows.size();) {
+            component.clear();
+            columns.clear();
+            size_t j = i;
+            for (; j < rows.size() && rows[j].first == rows[i].first; j++) {
+                component.push_back(rows[j].second);
+                const uint32_t* const p_xor = xors_.data() + rows[j].second;
+                columns.insert(columns.end(), p_xor + 2, p_xor + 2 + p_xor[0]);
+            };
+            if (!eliminate_component(component, columns)) {
+                return false;
+            };
+            i = j;
+        };
+
+        for (auto it: assignments_) {
+            if (!assign_equivalent(it.first, it.second)) {
+                return false;
+            };
+        };
+        append_derived();
+        return true;
+    };
+
+    bool CnfGaussianEliminator::execute() {
+        return execute(true, fpmOriginal);
+    };
+
+    bool CnfGaussianEliminator::execute(const bool b_reindex_variables, const FormulaProcessingMode mode) {
+        const bool result = eliminate_xors();
+        std::cout << "Gaussian elimination: " << std::dec << xors_size_ << " XOR(s), ";
+        std::cout << units_size_ << " unit(s), " << equivalent_size_ << " equivalent literal(s), ";
+        std::cout << appended_size_ << " XOR(s) appended, ";
+        operation_effort_.print(std::cout, "operation(s)");
+        std::cout << std::endl;
+        return result && CnfOptimizer::execute(b_reindex_variables, mode);
+    };
+
+};
@@ -0,0 +1,75 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfgaussian_hpp
+#define cnfgaussian_hpp
+
+#include "cnfoptimizer.hpp"
+
+namespace bal {
+
+    // XOR recovery and Gaussian elimination over GF(2)
+    // an XOR of n variables is encoded by the 2^(n-1) clauses excluding assignments of the other parity;
+    //   aggregated clauses are recognized by their flags, longer ones are grouped by variables
+    // XORs are split into components sharing variables; each component is a bit matrix
+    // with a column per variable and the parity in the last column, reduced by Gauss-Jordan elimination
+    //   a reduced row with a single variable is a unit,
+    //   a reduced row with two variables or two rows differing in pivots only make an equivalence,
+    //   other short reduced rows are appended as XOR clauses unless present
+    // the resulting assignments are passed to the optimizer as if they were specified up front
+    class CnfGaussianEliminator: public CnfOptimizer {
+    protected:
+        // longest unaggregated XOR recognized, it takes 2^(size - 1) clauses
+        static constexpr clause_size_t CNF_XOR_SIZE_MAX = 8;
+        // longest reduced row appended as an XOR clause
+        static constexpr clause_size_t CNF_XOR_APPEND_SIZE_MAX = 4;
+        // effort limits: matrix size and the number of 64 bit words XORed in total;
+        // the elimination also stops once the time limit is reached
+        static constexpr size_t CNF_GAUSS_MATRIX_WORDS_MAX = 1 << 24;
+        static constexpr size_t CNF_GAUSS_OPERATIONS_MAX = (size_t)1 << 32;
+
+    private:
+        // recovered XORs, each is its size and parity followed by variables
+        std::vector<uint32_t> xors_;
+        size_t xors_size_ = 0;
+        CnfEffort operation_effort_;
+
+        // derived units and equivalences as literal and value pairs
+        std::vector<std::pair<literalid_t, literalid_t>> assignments_;
+        // derived XORs, each is its size and parity followed by variables
+        std::vector<uint32_t> derived_;
+
+        size_t units_size_ = 0;
+        size_t equivalent_size_ = 0;
+        size_t appended_size_ = 0;
+
+        inline void append_xor(const literalid_t* const literals, const clause_size_t size, const uint32_t patterns[]);
+        inline void recover_xors();
+        inline bool eliminate_component(const std::vector<size_t>& rows, std::vector<uint32_t>& columns);
+        inline bool assign_equivalent(const literalid_t literal_id, const literalid_t value);
+        inline void append_derived();
+
+    protected:
+        // returns false if the formula is found unsatisfiable
+        bool eliminate_xors();
+
+    public:
+        CnfGaussianEliminator(Cnf& cnf, VariablesArray& variables): CnfOptimizer(cnf, variables) {};
+
+        bool execute() override;
+        bool execute(const bool b_reindex_variables, const FormulaProcessingMode mode) override;
+    };
+
+    inline bool eliminate_xors(Cnf& cnf, const bool b_reindex_variables, const FormulaProcessingMode mode) {
+        VariablesArray variables(cnf.variables_size(), 1);
+        variables.assign_sequence();
+        return CnfGaussianEliminator(cnf, variables).execute(b_reindex_variables, mode);
+    };
+
+};
+
+#endif /* cnfgaussian_hpp */
@@ -0,0 +1,234 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfimplications_hpp
+#define cnfimplications_hpp
+
+#include <vector>
+#include "assertlevels.hpp"
+#include "container.hpp"
+#include "variablesarray.hpp"
+#include "cnfclausescontainer.hpp"
+
+namespace bal {
+
+    // BINARY IMPLICATION GRAPH
+    // vertices are literals, each member (a | b) of a binary clause makes edges -a -> b and -b -> a
+    // literals are resolved against the variables array, clauses with assigned variables are skipped
+    //   equivalences: literals of a strongly connected component are equivalent;
+    //     each variable of the component is substituted by the literal of its lowest variable,
+    //     a component with both a literal and its negation means a conflict
+    //   transitive reduction: a clause member is redundant if its edge target is reachable
+    //     from the edge source through other members; the search is bounded
+    // both edges of a clause member are adjacent, the first one at an even index
+    class CnfImplicationGraph {
+    private:
+        struct edge_t {
+            // target literal
+            literalid_t literal;
+            // original clause offset and the member flag
+            container_offset_t offset;
+            clause_flags_t flags;
+            bool b_removed;
+            container_offset_t next;
+        };
+
+        // limit of literals visited while looking for another path
+        static constexpr size_t CNF_REDUCTION_VISITS_MAX = 1024;
+        static constexpr uint32_t INDEX_UNDEFINED = UINT32_MAX;
+
+        literalid_t* const variables_;
+        const uint32_t* const clauses_data_;
+        const size_t literals_size_;
+
+        Container<edge_t> edges_;
+        Container<container_offset_t> edges_first_;
+
+        size_t assigned_size_ = 0;
+        // clause with an edge within the component found to have complementary literals
+        container_offset_t conflict_offset_ = CONTAINER_END;
+
+        inline void link(const literalid_t source, const literalid_t target, const container_offset_t offset, const clause_flags_t flags) {
+            edges_.append({target, offset, flags, false, edges_first_.data_[source]}, 1);
+            edges_first_.data_[source] = edges_.size_ - 1;
+        };
+
+        // substitutes variables of the component by the literal of the lowest variable
+        // returns false if the component contains complementary literals
+        inline bool substitute(const literalid_t* const component, const size_t size, std::vector<uint32_t>& components, const uint32_t component_id) {
+            literalid_t representative = component[0];
+            for (auto i = 1; i < size; i++) {
+                if (component[i] < representative) {
+                    representative = component[i];
+                };
+            };
+            for (auto i = 0; i < size; i++) {
+                if (components[literal_t__negated(component[i])] == component_id) {
+                    // each literal of the component has an edge to another one of it
+                    for (container_offset_t j = edges_first_.data_[component[i]]; j != CONTAINER_END; j = edges_.data_[j].next) {
+                        if (components[edges_.data_[j].literal] == component_id) {
+                            conflict_offset_ = edges_.data_[j].offset;
+                            break;
+                        };
+                    };
+                    return false;
+                };
+            };
+            for (auto i = 0; i < size; i++) {
+                const variableid_t variable_id = literal_t__variable_id(component[i]);
+                if (component[i] != representative && variables_[variable_id] == variable_t__literal_id(variable_id)) {
+                    variables_[variable_id] = literal_t__negated_onlyif(representative, literal_t__is_negation(component[i]));
+                    assigned_size_++;
+                };
+            };
+            return true;
+        };
+
+        // depth first search for the target not following the edge pair and removed edges
+        inline bool is_reachable(const literalid_t source, const literalid_t target, const container_offset_t edge_index,
+                                 std::vector<uint32_t>& visited, const uint32_t stamp, std::vector<literalid_t>& stack) const {
+            size_t visits = 0;
+            stack.clear();
+            stack.push_back(source);
+            visited[source] = stamp;
+            while (!stack.empty() && visits < CNF_REDUCTION_VISITS_MAX) {
+                const literalid_t literal_id = stack.back();
+                stack.pop_back();
+                visits++;
+                for (container_offset_t i = edges_first_.data_[literal_id]; i != CONTAINER_END; i = edges_.data_[i].next) {
+                    const edge_t& edge = edges_.data_[i];
+                    if (!edge.b_removed && (i >> 1) != (edge_index >> 1) && visited[edge.literal] != stamp) {
+                        if (edge.literal == target) {
+                            return true;
+                        };
+                        visited[edge.literal] = stamp;
+                        stack.push_back(edge.literal);
+                    };
+                };
+            };
+            return false;
+        };
+
+    public:
+        CnfImplicationGraph(VariablesArray& variables, const uint32_t* const clauses_data):
+            variables_(variables.data()), clauses_data_(clauses_data), literals_size_((variables.size() + 1) << 1) {
+            edges_first_.append(CONTAINER_END, literals_size_);
+        };
+
+        // appends members of the binary clause unless a variable is assigned
+        inline void append(const container_offset_t offset) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_size(p_clause) != 2) {
+                return;
+            };
+            const literalid_t literal0 = literal_t::resolve(variables_, _clause_literal(p_clause, 0));
+            const literalid_t literal1 = literal_t::resolve(variables_, _clause_literal(p_clause, 1));
+            if (!literal_t__is_variable(literal0) || !literal_t__is_variable(literal1) || literal_t__is_same_variable(literal0, literal1)) {
+                return;
+            };
+            const clause_flags_t flags = _clause_flags(p_clause);
+            for (auto bits = 0; bits < 4; bits++) {
+                if (flags & (1 << bits)) {
+                    // literals of an aggregated clause are stored unnegated, resolved ones may be negated
+                    const literalid_t l0 = literal_t__negated_onlyif(literal0, (bits & 0b01) == 0);
+                    const literalid_t l1 = literal_t__negated_onlyif(literal1, (bits & 0b10) == 0);
+                    link(literal_t__negated(l0), l1, offset, 1 << bits);
+                    link(literal_t__negated(l1), l0, offset, 1 << bits);
+                };
+            };
+        };
+
+        // assigns equivalent literals through the variables array (Tarjan, iterative)
+        // returns false on conflict
+        inline bool substitute_equivalences() {
+            std::vector<uint32_t> indexes(literals_size_, (uint32_t)INDEX_UNDEFINED);
+            std::vector<uint32_t> lowlinks(literals_size_);
+            std::vector<uint32_t> components(literals_size_, (uint32_t)INDEX_UNDEFINED);
+            std::vector<literalid_t> stack;
+            // literals being visited with their next edges
+            std::vector<std::pair<literalid_t, container_offset_t>> path;
+            uint32_t index = 0;
+            uint32_t component_id = 0;
+
+            for (literalid_t root = 0; root < literals_size_; root++) {
+                if (indexes[root] != INDEX_UNDEFINED || edges_first_.data_[root] == CONTAINER_END) {
+                    continue;
+                };
+                indexes[root] = lowlinks[root] = index++;
+                stack.push_back(root);
+                path.push_back({root, edges_first_.data_[root]});
+                while (!path.empty()) {
+                    const literalid_t literal_id = path.back().first;
+                    container_offset_t& edge_index = path.back().second;
+                    if (edge_index != CONTAINER_END) {
+                        const literalid_t target = edges_.data_[edge_index].literal;
+                        edge_index = edges_.data_[edge_index].next;
+                        if (indexes[target] == INDEX_UNDEFINED) {
+                            indexes[target] = lowlinks[target] = index++;
+                            stack.push_back(target);
+                            path.push_back({target, edges_first_.data_[target]});
+                        } else if (components[target] == INDEX_UNDEFINED && indexes[target] < lowlinks[literal_id]) {
+                            // the target is on the stack
+                            lowlinks[literal_id] = indexes[target];
+                        };
+                        continue;
+                    };
+
+                    path.pop_back();
+                    if (!path.empty() && lowlinks[literal_id] < lowlinks[path.back().first]) {
+                        lowlinks[path.back().first] = lowlinks[literal_id];
+                    };
+                    if (lowlinks[literal_id] == indexes[literal_id]) {
+                        size_t start = stack.size();
+                        do {
+                            start--;
+                            components[stack[start]] = component_id;
+                        } while (stack[start] != literal_id);
+                        if (stack.size() - start > 1 && !substitute(stack.data() + start, stack.size() - start, components, component_id)) {
+                            return false;
+                        };
+                        stack.resize(start);
+                        component_id++;
+                    };
+                };
+            };
+            return true;
+        };
+
+        // calls remove(offset, flags) for each redundant clause member
+        // removed members are not followed, so the reachability is preserved
+        template<typename REMOVE_T>
+        inline size_t reduce(REMOVE_T remove) {
+            std::vector<uint32_t> visited(literals_size_, 0);
+            std::vector<literalid_t> stack;
+            uint32_t stamp = 0;
+            size_t removed_size = 0;
+            for (literalid_t source = 0; source < literals_size_; source++) {
+                for (container_offset_t i = edges_first_.data_[source]; i != CONTAINER_END; i = edges_.data_[i].next) {
+                    edge_t& edge = edges_.data_[i];
+                    // each member is checked once by its first edge
+                    if ((i & 1) == 0 && !edge.b_removed && is_reachable(source, edge.literal, i, visited, ++stamp, stack)) {
+                        edge.b_removed = true;
+                        edges_.data_[i + 1].b_removed = true;
+                        remove(edge.offset, edge.flags);
+                        removed_size++;
+                    };
+                };
+            };
+            return removed_size;
+        };
+
+        // number of variables substituted by equivalent literals
+        inline size_t assigned_size() const { return assigned_size_; };
+        
+        // offset of a clause of the conflicting component after substitute_equivalences() fails
+        inline container_offset_t conflict_offset() const { return conflict_offset_; };
+    };
+
+};
+
+#endif /* cnfimplications_hpp */
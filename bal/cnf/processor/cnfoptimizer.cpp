@@ -14,51 +14,6 @@
 
 namespace bal {
  
-    /////////////////////////////
-    //  Utilities
-    /////////////////////////////
-    
-    inline void __reduce_clause_flags(uint16_t& flags, const clause_size_t index, const literalid_t value) {
-        switch ((index << 1) + value) {
-            case 0: // variable 0, value 0
-                flags =
-                (flags & 0x0002) >> 1 | (flags & 0x0008) >> 2 |
-                (flags & 0x0020) >> 3 | (flags & 0x0080) >> 4 |
-                (flags & 0x0200) >> 5 | (flags & 0x0800) >> 6 |
-                (flags & 0x2000) >> 7 | (flags & 0x8000) >> 8;
-                break;
-            case 1: // variable 0, value 1
-                flags =
-                (flags & 0x0001)      | (flags & 0x0004) >> 1 |
-                (flags & 0x0010) >> 2 | (flags & 0x0040) >> 3 |
-                (flags & 0x0100) >> 4 | (flags & 0x0400) >> 5 |
-                (flags & 0x1000) >> 6 | (flags & 0x4000) >> 7;
-                break;
-            case 2: // variable 1, value 0
-                flags =
-                (flags & 0x000C) >> 2 | (flags & 0x00C0) >> 4 |
-                (flags & 0x0C00) >> 6 | (flags & 0xC000) >> 8;
-                break;
-            case 3: // variable 1, value 1
-                flags =
-                (flags & 0x0003)      | (flags & 0x0030) >> 2 |
-                (flags & 0x0300) >> 4 | (flags & 0x3000) >> 6;
-                break;
-            case 4: // variable 2, value 0
-                flags = (flags & 0x00F0) >> 4 | (flags & 0xF000) >> 8;
-                break;
-            case 5: // variable 2, value 1
-                flags = (flags & 0x000F)      | (flags & 0x0F00) >> 4;
-                break;
-            case 6: // variable 3, value 0
-                flags = (flags & 0xFFFF) >> 8;
-                break;
-            case 7: // variable 3, value 1
-                flags = (flags & 0x00FF);
-                break;
-        };
-    };
-
     /////////////////////////////
     //  Tracer
     /////////////////////////////
@@ -120,23 +75,110 @@ namespace bal {
             TRACE_CLAUSE_REMOVE(offset);
         };
 #endif
-        _clauses_offset_exclude(clauses_data_, offset);
+        if (!clauses_.transaction_offset_is_immutable(offset) && _clauses_offset_is_included(clauses_data_, offset)) {
+            excluded_size_ += _clauses_offset_size_memory_size(_clauses_offset_size(clauses_data_, offset));
+        };
+        clauses_.exclude(offset);
+    };
+    
+    // an excluded clause may be found and merged into a new one for as long as its variables are unassigned
+    // once any variable is assigned, the clause cannot match a normalized clause anymore
+    inline bool CnfOptimizer::is_clause_obsolete(const uint32_t* const p_clause) const {
+        const literalid_t* const variables = variables_.data();
+        for (auto i = 0; i < _clause_size(p_clause); i++) {
+            const variableid_t variable_id = _clause_variable(p_clause, i);
+            if (variables[variable_id] != variable_t__literal_id(variable_id)) {
+                return true;
+            };
+        };
+        return false;
     };
     
     inline processor_result_t CnfOptimizer::process_clause_evaluate(uint32_t* const p_clause) {
         
-        if ((evaluations_ & 0x3FFF) == 0) {
+        if ((evaluations_ & 0x3FFF) == 0 && !b_silent_) {
              std::cout << "s:" << std::dec << std::setfill(' ') << std::setw(8) << (clauses_size_ >> 10) << " Kb d: " << std::setw(8) << ((clauses_size_ - processed_offset_) >> 10) << "Kb v: " << std::setw(8) << variables_assigned_ << std::flush << "\r";
         };
         
         _assert_level_3(p_clause == _clauses_offset_clause(clauses_data_, processed_offset_));
         const processor_result_t result = evaluate_clause(processed_offset_);
-        if (result == erConflict) {
+        if (result == erConflict && !b_silent_) {
             __print_conflict(variables_.data(), p_clause);
         };
         return result;
     };
 
+    // assign constants implied by unit clauses before evaluating clauses one by one
+    // otherwise a clause is normalized again each time one of its variables is assigned
+    // and most clauses visited this way are nowhere near unit
+    inline processor_result_t CnfOptimizer::propagate_units() {
+        CnfUnitPropagator propagator(variables_, clauses_data_);
+        bool result = true;
+        container_offset_t offset = 0;
+        while (result && offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause)) {
+                result = propagator.append(offset);
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        result = result && propagator.propagate();
+        variables_assigned_ += propagator.assigned_size();
+        if (!result) {
+            if (!b_silent_) {
+                __print_conflict(variables_.data(), _clauses_offset_clause(clauses_data_, propagator.conflict_offset()));
+            };
+            return erConflict;
+        };
+        return erUndetermined;
+    };
+    
+    // substitute literals equivalent through chains of binary clauses before evaluating clauses
+    // otherwise each equivalence is derived by resolution and appended one step at a time
+    inline processor_result_t CnfOptimizer::substitute_equivalences() {
+        CnfImplicationGraph graph(variables_, clauses_data_);
+        container_offset_t offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause)) {
+                graph.append(offset);
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        const bool result = graph.substitute_equivalences();
+        variables_assigned_ += graph.assigned_size();
+        if (!result) {
+            if (!b_silent_) {
+                __print_conflict(variables_.data(), _clauses_offset_clause(clauses_data_, graph.conflict_offset()));
+            };
+            return erConflict;
+        };
+        return erUndetermined;
+    };
+    
+    // exclude binary clause members implied by other binary clauses
+    // expects the clauses to be normalized and outside of the transaction
+    inline void CnfOptimizer::reduce_implications() {
+        CnfImplicationGraph graph(variables_, clauses_data_);
+        container_offset_t offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause)) {
+                graph.append(offset);
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        graph.reduce([this](const container_offset_t offset, const clause_flags_t flags) {
+            uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            const clause_flags_t clause_flags = _clause_flags(p_clause) & ~flags;
+            if (clause_flags == 0) {
+                exclude_clause(offset);
+            } else {
+                _clause_flags_set(p_clause, clause_flags);
+            };
+        });
+    };
+    
     // process clauses one by one
     // the list will grow after each optimization
     // therefore the process will stop when consequences of all optimizations are evaluated
@@ -144,14 +186,31 @@ namespace bal {
         evaluations_ = 0;
         evaluations_aggregated_ = 0;
         variables_assigned_ = 0;
+        resolution_effort_ = CnfEffort(get_cnf_effort_limits().resolvents);
+        bool b_propagate = true;
+#ifdef CNF_TRACE
+        // tracers refer to clauses by offsets which must not change
+        b_compaction_enabled_ = (p_tracer_ == nullptr);
+        // tracers record each assignment with the clauses it changes
+        b_propagate = (p_tracer_ == nullptr);
+#endif
         
-        const processor_result_t result = process_clauses<CnfOptimizer, &CnfOptimizer::process_clause_evaluate>(this);
+        processor_result_t result = b_propagate ? propagate_units() : erUndetermined;
+        if (result != erConflict && b_propagate) {
+            result = substitute_equivalences();
+        };
+        if (result != erConflict) {
+            result = process_clauses<CnfOptimizer, &CnfOptimizer::process_clause_evaluate>(this);
+        };
         
-        std::cout << "Evaluation: " << std::dec << evaluations_ << "/" << evaluations_aggregated_ << " cls, size: ";
-        std::cout << cnf_.clauses_size() << "/" << cnf_.clauses_size<0, true>() << " cls, ";
-        std::cout << (cnf_.memory_size() >> 10) << "/";
-        std::cout << (clauses_index_.memory_size() >> 10) << " Kb";
-        std::cout << std::endl;
+        if (!b_silent_) {
+            std::cout << "Evaluation: " << std::dec << evaluations_ << "/" << evaluations_aggregated_ << " cls, size: ";
+            std::cout << cnf_.clauses_size() << "/" << cnf_.clauses_size<0, true>() << " cls, ";
+            std::cout << (cnf_.memory_size() >> 10) << "/";
+            std::cout << (clauses_index_.memory_size() >> 10) << " Kb, ";
+            resolution_effort_.print(std::cout, "resolvent(s)");
+            std::cout << std::endl;
+        };
         
         return result;
     };
@@ -249,7 +308,8 @@ namespace bal {
         const clause_size_t clause_size = _clause_size(p_src);
         const literalid_t* const literals = _clause_literals(p_src);
         uint16_t flags = _clause_flags(p_src);
-        const literalid_t* const variable_values = variables_.data();
+        // resolving compresses the paths to the values
+        literalid_t* const variable_values = variables_.data();
         
         literalid_t* new_literals = _clause_literals(p_dst);
         clause_size_t new_clause_size = 0;
@@ -259,7 +319,7 @@ namespace bal {
         for (auto i = 0; i < clause_size && flags != 0; i++) {
             const literalid_t original_value = literals[i]; // because p_src may == p_dst
             _assert_level_0(literal_t__is_variable(original_value) && !literal_t__is_negation(original_value));
-            literalid_t new_value = literal_t::resolve(variable_values, original_value);
+            literalid_t new_value = literal_t::resolve_compress(variable_values, original_value);
             
             if (literal_t__is_variable(new_value)) {
                 if (literal_t__is_negation(new_value)) {
@@ -276,7 +336,7 @@ namespace bal {
             } else { // is_constant
                 __TRACE_ASSIGN_LITERAL;
                 new_literals[new_clause_size] = new_value;
-                __reduce_clause_flags(flags, new_clause_size, new_value);
+                ca_flags_reduce(flags, new_clause_size, new_value);
                 if (result == erUndetermined) {
                     result = erChangedC;
                 };
@@ -292,7 +352,8 @@ namespace bal {
         
         const literalid_t* literals = _clause_literals(p_src);
         const clause_size_t clause_size = _clause_size(p_src);
-        const literalid_t* const var_values = variables_.data();
+        // resolving compresses the paths to the values
+        literalid_t* const var_values = variables_.data();
             
         // an unaggregated clause indeed
         _assert_level_1(!_clause_size_is_aggregated(clause_size));
@@ -302,7 +363,7 @@ namespace bal {
         
         for (auto i = 0; i < clause_size; i++) {
             const literalid_t original_value = literals[i]; // because p_src may == p_dst
-            const literalid_t new_value = literal_t::resolve(var_values, original_value);
+            const literalid_t new_value = literal_t::resolve_compress(var_values, original_value);
             // count resolved literal if not a constant
             if (literal_t__is_variable(new_value)) {
                 if (new_value != original_value) {
@@ -734,9 +795,11 @@ namespace bal {
                     offset = iterator.next();
                 };
             };
-        } else {
-            // the same constant can be assigned again while updating indexes recursively
-            _assert_level_0(old_value == value);
+        } else if (old_value != value) {
+            // the same constant can be assigned again while updating indexes recursively;
+            // the opposite one, when an aggregate implying more than one unit is evaluated
+            // after recursive evaluation has assigned the other one already
+            result = erConflict;
         };
         TRACE_LEVEL_PREV;
         TRACE_LEVEL_PREV;
@@ -778,7 +841,7 @@ namespace bal {
             (ca_size < 4 || ca_index == 3 || _clause_literal(p_ca, 3) == variables[literal_t__variable_id(_clause_literal(p_ca, 3))])
                                                   );
         
-        if (is_clause_unchanged) {
+        if (is_clause_unchanged && !resolution_effort_.is_exhausted()) {
             // determine the resolvent flags
             clause_flags_t resolvent_flags = ca_flags;
             resolve_ca_c2_flags(resolvent_flags, ca_index, c2_index, _clause_flags(p_c2));
@@ -811,6 +874,7 @@ namespace bal {
                     _assert_level_2(resolvent_size == ca_size);
                     _assert_level_3(normalize_ca(resolvent, resolvent) == erUndetermined);
                     
+                    resolution_effort_.spend();
                     processor_result_t result = evaluate_clause_a(resolvent);
                     
                     TRACE_LEVEL_PREV;
@@ -914,7 +978,7 @@ namespace bal {
                         __insertion_point_t_init(insertion_point); // suboptimal, can reuse the above find
                         clauses_.append<false>(p_ca1, insertion_point);
                         TRACE_CLAUSE_APPEND(p_ca1);
-                        _assert_level_1(insertion_point.kind == btipkCurrent);
+                        _assert_level_1(insertion_point.container_offset != CONTAINER_END);
                         ca1_offset = insertion_point.container_offset;
                     } else {
                         caca_expand_flags<size1, size2, index1, index2, index3>(flags);
@@ -1081,8 +1145,9 @@ namespace bal {
             literal_t__variable_id(_clause_literal(p_clause, 1))
         };
         
+        // once out of budget, the transitive closure is left incomplete
         container_offset_t ca_offset = iterator.first(c2_variables);
-        while (ca_offset != CLAUSES_END) {
+        while (ca_offset != CLAUSES_END && !resolution_effort_.is_exhausted()) {
             uint32_t* p_ca = _clauses_offset_clause(clauses_data_, ca_offset);
             const clause_size_t ca_size = _clause_size(p_ca);
             switch(ca_size) {
@@ -1140,7 +1205,7 @@ namespace bal {
         return (result != erSatisfied);
     };
     
-    inline bool CnfOptimizer::_update_clause_variables(uint32_t* const p_clause) const {
+    bool CnfOptimizer::_update_clause_variables(uint32_t* const p_clause) const {
         if (_clause_is_included(p_clause)) {
             const uint32_t clause_size = _clause_size(p_clause);
             const literalid_t* var_values = variables_.data();
@@ -1173,10 +1238,25 @@ namespace bal {
      
     // reindex variables such that there are no gaps in variable numbers
     // update CNF variables count
-    inline variableid_t CnfOptimizer::update_variables(const bool b_reindex_variables) {
+    variableid_t CnfOptimizer::update_variables(const bool b_reindex_variables) {
         literalid_t* var_values = variables_.data();
         variableid_t next_variable_id = VARIABLEID_MIN;
         
+        // variables referenced by named ones are kept even if all their clauses are gone
+        // e.g. equivalences assigned by probing before the optimizer excludes the clauses
+        std::vector<bool> b_named_references(variables_.size(), false);
+        for (auto vit = named_variables_.begin(); vit != named_variables_.end(); vit++) {
+            const literalid_t* const template_ = vit->second.data();
+            for (auto i = 0; i < vit->second.size(); i++) {
+                if (literal_t__is_variable(template_[i])) {
+                    const literalid_t literal_id = literal_t::resolve(var_values, template_[i]);
+                    if (literal_t__is_variable(literal_id)) {
+                        b_named_references[literal_t__variable_id(literal_id)] = true;
+                    };
+                };
+            };
+        };
+        
         // go through the variables sequentially
         for (variables_size_t i = 0; i < variables_.size(); i++) {
             if (literal_t__is_variable(var_values[i])) {
@@ -1187,11 +1267,15 @@ namespace bal {
                     assert(i > variable_id);
                     // all clauses with the variable must have been excluded
                     assert(!is_variable_used(i));
-                    // UNASSIGNED may not be referenced
-                    assert(!literal_t__is_unassigned(var_values[variable_id]));
-                    // take the reference of the reference instead of making a new variable
-                    var_values[i] = literal_t__substitute_literal(var_values[i], var_values[variable_id]);
-                } else if (is_variable_used(variable_id) || cnf_.is_variable_named(variable_id)) {
+                    if (literal_t__is_unassigned(var_values[variable_id])) {
+                        // the referenced variable is gone with all its clauses, so is this one
+                        assert(!cnf_.is_variable_named(i));
+                        var_values[i] = LITERALID_UNASSIGNED;
+                    } else {
+                        // take the reference of the reference instead of making a new variable
+                        var_values[i] = literal_t__substitute_literal(var_values[i], var_values[variable_id]);
+                    };
+                } else if (is_variable_used(variable_id) || cnf_.is_variable_named(variable_id) || b_named_references[variable_id]) {
                     if (b_reindex_variables) {
                         // generate new variable id
                         if (next_variable_id != variable_id) {
@@ -1217,6 +1301,22 @@ namespace bal {
         return next_variable_id;
     };
         
+    // lighter version of update_variables() with no reindexing
+    void CnfOptimizer::resolve_variables() {
+        literalid_t* var_values = variables_.data();
+        
+        // go through the variables sequentially
+        for (variableid_t i = 0; i < variables_.size(); i++) {
+            const literalid_t value = var_values[i];
+            if (literal_t__is_variable(value) && i != literal_t__variable_id(value)) {
+                _assert_level_1(i > literal_t__variable_id(value));
+                const literalid_t new_value = var_values[literal_t__variable_id(value)];
+                _assert_level_1(!literal_t__is_unassigned(new_value));
+                var_values[i] = literal_t__substitute_literal(value, new_value);
+            };
+        };
+    };
+    
     // generate clauses for constant and variable values
     // check presence of existant unit clauses and the conflicts
     // return false if there is a conflict
@@ -1257,11 +1357,13 @@ namespace bal {
         return true;
     };
     
-    inline bool CnfOptimizer::base_execute(const bool b_reindex_variables, const FormulaProcessingMode mode) {
+    bool CnfOptimizer::base_execute(const bool b_reindex_variables, const FormulaProcessingMode mode) {
         _assert_level_0(mode == fpmAll || mode == fpmOriginal);
         
         clauses_.transaction_begin();
-        __statistics_reset();
+        if (!b_silent_) {
+            __statistics_reset();
+        };
         
         TRACE_START;
         bool result = (evaluate_clauses() != erConflict);
@@ -1269,7 +1371,9 @@ namespace bal {
         
         if (result) {
             
-            __statistics_print();
+            if (!b_silent_) {
+                __statistics_print();
+            };
             
             if (mode == fpmOriginal) {
                 // "lazy" suboptimal approach until transitive reduction works efficiently
@@ -1281,9 +1385,22 @@ namespace bal {
                 rebuild_clauses<CnfOptimizer, &CnfOptimizer::_normalize_clause>(this, false);
                 // this may leave excluded clauses; second reinitialization addresses this
                 CnfSubsumptionOptimizer::execute();
+                if (!b_silent_) {
+                    std::cout << "Subsumption: ";
+                    subsumption_effort_.print(std::cout, "check(s)");
+                    std::cout << std::endl;
+                };
             } else if (mode == fpmAll) {
                 clauses_.transaction_commit();
             };
+            bool b_reduce = true;
+#ifdef CNF_TRACE
+            // tracers are not notified of clause members excluded by the reduction
+            b_reduce = (p_tracer_ == nullptr);
+#endif
+            if (b_reduce) {
+                reduce_implications();
+            };
             
             const variableid_t new_variables_size = update_variables(b_reindex_variables);
             rebuild_clauses<CnfOptimizer, &CnfOptimizer::_update_clause_variables>(this, mode == fpmAll);
@@ -1315,17 +1432,21 @@ namespace bal {
             
             bool result = base_execute(b_reindex_variables, mode);
             if (result) {
-                std::cout << "Optimized: " << std::dec;
-                std::cout << "(" << variables_.size() << ", " << original_clauses_size << ") -> ";
-                std::cout << "(" << (signed long)cnf_.variables_size() - variables_.size() << ", ";
-                std::cout << (signed long)cnf_.clauses_size() - original_clauses_size << ") -> ";
-                std::cout << "(" << cnf_.variables_size() << ", " << cnf_.clauses_size() << ")";
-                std::cout << std::endl;
+                print_optimized(original_clauses_size);
             };
             return result;
         };
     };
     
+    void CnfOptimizer::print_optimized(const clauses_size_t original_clauses_size) const {
+        std::cout << "Optimized: " << std::dec;
+        std::cout << "(" << variables_.size() << ", " << original_clauses_size << ") -> ";
+        std::cout << "(" << (signed long)cnf_.variables_size() - variables_.size() << ", ";
+        std::cout << (signed long)cnf_.clauses_size() - original_clauses_size << ") -> ";
+        std::cout << "(" << cnf_.variables_size() << ", " << cnf_.clauses_size() << ")";
+        std::cout << std::endl;
+    };
+    
     // CnfVariableEvaluator
     
     bool CnfVariableEvaluator::execute() {
@@ -1335,23 +1456,117 @@ namespace bal {
         
         if (result) {
             // update variables to resolve any sequenced references
-            // lighter version of update_variables() with no reindexing
-            literalid_t* var_values = variables_.data();
-            
-            // go through the variables sequentially
-            for (variableid_t i = 0; i < variables_.size(); i++) {
-                const literalid_t value = var_values[i];
-                if (literal_t__is_variable(value) && i != literal_t__variable_id(value)) {
-                    _assert_level_1(i > literal_t__variable_id(value));
-                    const literalid_t new_value = var_values[literal_t__variable_id(value)];
-                    _assert_level_1(!literal_t__is_unassigned(new_value));
-                    var_values[i] = literal_t__substitute_literal(value, new_value);
-                };
+            resolve_variables();
+        };
+        return result;
+    };
+    
+    // CnfIncrementalOptimizer
+    
+    bool CnfIncrementalOptimizer::execute() {
+        return execute(false, fpmAll);
+    };
+    
+    bool CnfIncrementalOptimizer::execute(const bool b_reindex_variables, const FormulaProcessingMode mode) {
+        _assert_level_0(!clauses_.transaction_is_in());
+        const bool result = CnfOptimizer::execute(false, mode);
+        b_processed_ = result && mode != fpmUnoptimized;
+        if (b_processed_) {
+            build_clauses_index();
+        };
+        return result;
+    };
+    
+    // begins the transaction or a savepoint within it
+    inline void CnfIncrementalOptimizer::transaction_begin() {
+        clauses_.transaction_begin();
+        clauses_index_.transaction_begin();
+        original_variables_.push_back(variables_);
+    };
+    
+    bool CnfIncrementalOptimizer::assign(const VariablesArray& values) {
+        _assert_level_0(b_processed_ && values.size() == variables_.size());
+#ifdef CNF_TRACE
+        _assert_level_0(p_tracer_ == nullptr);
+#endif
+        if (!clauses_.transaction_is_in()) {
+            transaction_begin();
+        };
+        // within a savepoint, clauses are appended rather than merged into those evaluated before
+        clauses_.transaction_begin();
+        
+        // clauses before the first appended one are in the index already
+        const container_offset_t offset = clauses_size_;
+        bool result = true;
+        const literalid_t* const variables = variables_.data();
+        for (variableid_t i = 0; result && i < values.size(); i++) {
+            const literalid_t value = values.data()[i];
+            if (value == variable_t__literal_id(i) || literal_t__is_unassigned(value) ||
+                literal_t__is_unassigned(variables[i]) ||
+                (literal_t__is_variable(value) && literal_t__is_unassigned(variables[literal_t__variable_id(value)]))) {
+                // not assigned or not in the formula anymore
+                continue;
+            };
+            const literalid_t literal_id = literal_t::resolve(variables, variable_t__literal_id(i));
+            const literalid_t other = literal_t::resolve(variables, value);
+            if (literal_id == other) {
+                continue;
+            } else if (literal_t__is_constant(literal_id) && literal_t__is_constant(other)) {
+                result = false;
+            } else if (literal_t__is_constant(literal_id)) {
+                clauses_.append_clause_l(literal_t__negated_onlyif(other, literal_t__is_constant_0(literal_id)));
+            } else if (literal_t__is_constant(other)) {
+                clauses_.append_clause_l(literal_t__negated_onlyif(literal_id, literal_t__is_constant_0(other)));
+            } else {
+                // equality, 2 clauses; a variable equal to its negation gives 2 unit clauses
+                clauses_.append_clause_l(literal_id, literal_t__negated(other));
+                clauses_.append_clause_l(literal_t__negated(literal_id), other);
             };
         };
+        
+        evaluations_ = 0;
+        evaluations_aggregated_ = 0;
+        variables_assigned_ = 0;
+        resolution_effort_ = CnfEffort(get_cnf_effort_limits().resolvents);
+        result = result && process_clauses<CnfOptimizer, &CnfOptimizer::process_clause_evaluate>(this, offset) != erConflict;
+        clauses_.transaction_commit();
         return result;
     };
     
+    inline bool CnfIncrementalOptimizer::_normalize_included_clause(uint32_t* const p_clause) const {
+        return _clause_is_included(p_clause) && _normalize_clause(p_clause);
+    };
+    
+    void CnfIncrementalOptimizer::savepoint() {
+        _assert_level_0(b_processed_);
+        if (!clauses_.transaction_is_in()) {
+            transaction_begin();
+        };
+        transaction_begin();
+    };
+    
+    void CnfIncrementalOptimizer::commit() {
+        _assert_level_0(clauses_.transaction_is_in() && original_variables_.size() == 1);
+        original_variables_.clear();
+        clauses_.transaction_commit();
+        clauses_index_.transaction_commit();
+        // unit clauses appended are left satisfied, changed clauses may have been shortened in place
+        rebuild_clauses<CnfIncrementalOptimizer, &CnfIncrementalOptimizer::_normalize_included_clause>(this, true);
+        resolve_variables();
+        cnf_.named_variables_update(variables_);
+        build_clauses_index();
+    };
+    
+    void CnfIncrementalOptimizer::rollback() {
+        _assert_level_0(clauses_.transaction_is_in());
+        clauses_.transaction_rollback();
+        // links of clauses unlinked by iterators are restored, items of the clauses appended are dropped
+        clauses_index_.transaction_rollback();
+        const VariablesArray& original_variables = original_variables_.back();
+        std::copy(original_variables.data(), original_variables.data() + variables_.size(), variables_.data());
+        original_variables_.pop_back();
+    };
+    
     // CnfVariableNormalizer
     
     bool CnfVariableNormalizer::execute(const bool b_reindex_variables) {
@@ -1388,4 +1603,36 @@ namespace bal {
         
         return true;
     };
+    
+    // CnfClausesSubsumer
+    
+    bool CnfClausesSubsumer::execute() {
+        return execute(true);
+    };
+    
+    bool CnfClausesSubsumer::execute(const bool b_reindex_variables) {
+        const variables_size_t original_variables_size = cnf_.variables_size();
+        const clauses_size_t original_clauses_size = cnf_.clauses_size();
+        
+        // leaves the index of the remaining clauses for checking if a variable is used
+        CnfSubsumptionOptimizer::execute();
+        
+        const variableid_t new_variables_size = update_variables(b_reindex_variables);
+        rebuild_clauses<CnfOptimizer, &CnfOptimizer::_update_clause_variables>(this, false);
+        cnf_.named_variables_update(variables_);
+        if (b_reindex_variables && new_variables_size != cnf_.variables_size()) {
+            set_variables_size(new_variables_size);
+        };
+        
+        std::cout << "Subsumption: " << std::dec;
+        std::cout << "(" << original_variables_size << ", " << original_clauses_size << ") -> ";
+        std::cout << "(" << cnf_.variables_size() << ", " << cnf_.clauses_size() << "), ";
+        subsumption_effort_.print(std::cout, "check(s)");
+        std::cout << std::endl;
+        
+        clauses_index_.reset(0, 0);
+        processed_offset_ = 0; // to match state of the indexes
+        
+        return true;
+    };
 };
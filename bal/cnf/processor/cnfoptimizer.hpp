@@ -10,6 +10,8 @@
 
 #include "variablesio.hpp"
 #include "cnfsubsumption.hpp"
+#include "cnfpropagator.hpp"
+#include "cnfimplications.hpp"
 
 #ifdef CNF_TRACE
 #include "cnftracer.hpp"
@@ -30,6 +32,11 @@ namespace bal {
         uint64_t evaluations_;
         uint64_t evaluations_aggregated_;
         uint64_t variables_assigned_;
+        // resolvents produced by resolve_ca_c2
+        CnfEffort resolution_effort_;
+        
+        // no progress, statistics and conflict output, e.g. for formulas processed on separate threads
+        bool b_silent_ = false;
          
     private:
         inline void exclude_clause(const container_offset_t offset);
@@ -47,6 +54,11 @@ namespace bal {
         
         // unit propagation / unary clauses - assignment
         inline processor_result_t assign_literal_value(const literalid_t literal_id, const literalid_t value);
+        inline processor_result_t propagate_units();
+        
+        // binary implication graph
+        inline processor_result_t substitute_equivalences();
+        inline void reduce_implications();
         
         // resolution
         template<bool b_ca_master, clause_size_t ca_size, clause_size_t ca_index, clause_size_t c2_index>
@@ -73,18 +85,23 @@ namespace bal {
         // reindex variables such that there are no gaps in variable numbers
         // update CNF variables count
         // returns new variables_size
-        inline variableid_t update_variables(const bool b_reindex_variables);
+        variableid_t update_variables(const bool b_reindex_variables);
+        // resolve references to variables which reference other variables, no reindexing
+        void resolve_variables();
         
         processor_result_t evaluate_clauses();
-        inline bool base_execute(const bool b_reindex_variables, const FormulaProcessingMode mode);
+        bool base_execute(const bool b_reindex_variables, const FormulaProcessingMode mode);
+        void print_optimized(const clauses_size_t original_clauses_size) const;
 
     public:
         // processing
         // these methods are executed using process_clauses template
         inline processor_result_t process_clause_evaluate(uint32_t* const p_clause);
         
+        inline bool is_clause_obsolete(const uint32_t* const p_clause) const;
+        
         inline bool _normalize_clause(uint32_t* const p_clause) const;
-        inline bool _update_clause_variables(uint32_t* const p_clause) const;
+        bool _update_clause_variables(uint32_t* const p_clause) const;
         
     public:
         CnfOptimizer(Cnf& cnf, VariablesArray& variables): CnfSubsumptionOptimizer(cnf), variables_(variables) {
@@ -112,13 +129,60 @@ namespace bal {
         virtual bool execute(const bool b_reindex_variables);
     };
     
-    inline bool evaluate(Cnf& cnf, VariablesArray& variables) {
-        return CnfVariableEvaluator(cnf, variables).execute();
+    // subsumption and self-subsuming resolution on their own, e.g. after another technique
+    // subsumed clauses are dropped, variables are updated the same way as after optimization
+    class CnfClausesSubsumer: public CnfOptimizer {
+    public:
+        CnfClausesSubsumer(Cnf& cnf, VariablesArray& variables): CnfOptimizer(cnf, variables) {};
+        
+        bool execute() override;
+        virtual bool execute(const bool b_reindex_variables);
     };
     
-    inline bool process(Cnf& cnf, VariablesArray& variables,
-                        const bool b_reindex_variables, const FormulaProcessingMode mode) {
-        return bal::CnfOptimizer(cnf, variables).execute(b_reindex_variables, mode);
+    // keeps the clauses index of a processed formula so that further assignments
+    // are evaluated starting from the clauses of the assigned variables only
+    // execute() processes the formula in full; variables are never reindexed
+    // so that the variables array and the named variables keep matching the formula
+    // assign() appends unit and equality clauses for values differing from the current ones,
+    // values of variables not in the formula anymore or referring to those are ignored,
+    // and evaluates them the same way as clauses appended while processing;
+    // derived clauses are kept as with fpmAll
+    // the first assign() or savepoint() since execute() or commit() begins a transaction;
+    //   savepoint() begins a savepoint within it, savepoints nest;
+    //   commit() keeps the changes, normalizes all clauses and updates named variables, savepoints must be closed;
+    //   rollback() restores clauses, the index and variable values as of the innermost savepoint begin,
+    //   or the transaction begin if there is none; the index is restored from its undo log
+    //   at the cost of the changes made since, see ContainerIndex::transaction_rollback
+    // after a conflict, only rollback() may follow
+    // not intended for tracing
+    class CnfIncrementalOptimizer: public CnfOptimizer {
+    private:
+        bool b_processed_ = false;
+        // variable values as of the transaction begin, then as of each savepoint begin
+        std::vector<VariablesArray> original_variables_;
+        
+        inline void transaction_begin();
+        inline bool _normalize_included_clause(uint32_t* const p_clause) const;
+        
+    public:
+        CnfIncrementalOptimizer(Cnf& cnf, VariablesArray& variables): CnfOptimizer(cnf, variables) {};
+        
+        bool execute() override;
+        // b_reindex_variables is disregarded
+        bool execute(const bool b_reindex_variables, const FormulaProcessingMode mode) override;
+        
+        // values must match the formula, those unchanged must be set to self
+        // returns false if the formula becomes unsatisfiable
+        bool assign(const VariablesArray& values);
+        void savepoint();
+        void commit();
+        void rollback();
+        
+        inline bool transaction_is_in() const { return clauses_.transaction_is_in(); };
+    };
+    
+    inline bool evaluate(Cnf& cnf, VariablesArray& variables) {
+        return CnfVariableEvaluator(cnf, variables).execute();
     };
     
     inline bool normalize_variables(Cnf& cnf, const bool b_reindex_variables) {
@@ -127,6 +191,12 @@ namespace bal {
         return CnfVariableNormalizer(cnf, variables).execute(b_reindex_variables);
     };
     
+    inline bool subsume_clauses(Cnf& cnf, const bool b_reindex_variables) {
+        VariablesArray variables(cnf.variables_size(), 1);
+        variables.assign_sequence();
+        return CnfClausesSubsumer(cnf, variables).execute(b_reindex_variables);
+    };
+    
 #ifdef CNF_TRACE
     
     void set_cnf_tracer(Ref<CnfTracer> p_tracer);
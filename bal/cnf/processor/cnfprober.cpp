@@ -0,0 +1,171 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <algorithm>
+#include <iostream>
+#include "cnfprober.hpp"
+
+namespace bal {
+
+    // unassigned variables ordered by the number of binary clause members, the highest first
+    inline void CnfLiteralProber::collect_candidates(std::vector<variableid_t>& candidates) const {
+        const literalid_t* const variables = variables_.data();
+        std::vector<uint32_t> degrees(variables_.size(), 0);
+        container_offset_t offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause) && _clause_size(p_clause) == 2) {
+                const uint32_t members_size = __builtin_popcount(_clause_flags(p_clause));
+                degrees[_clause_variable(p_clause, 0)] += members_size;
+                degrees[_clause_variable(p_clause, 1)] += members_size;
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+
+        std::vector<bool> b_candidates(variables_.size(), variable_name_.empty());
+        if (!variable_name_.empty()) {
+            const auto it = named_variables_.find(variable_name_);
+            if (it != named_variables_.end()) {
+                for (auto i = 0; i < it->second.size(); i++) {
+                    const literalid_t literal_id = literal_t::resolve(variables, it->second.data()[i]);
+                    if (literal_t__is_variable(literal_id)) {
+                        b_candidates[literal_t__variable_id(literal_id)] = true;
+                    };
+                };
+            };
+        };
+
+        for (variableid_t i = 0; i < variables_.size(); i++) {
+            if (b_candidates[i] && variables[i] == variable_t__literal_id(i) && (degrees[i] > 0 || !variable_name_.empty())) {
+                candidates.push_back(i);
+            };
+        };
+        std::stable_sort(candidates.begin(), candidates.end(), [&degrees](const variableid_t a, const variableid_t b) {
+            return degrees[a] > degrees[b];
+        });
+    };
+
+    // makes the literal equivalent to the value, the higher variable references the lower one
+    // returns false if the literal turns out to be the negation of the value
+    inline bool CnfLiteralProber::assign_equivalent(const literalid_t literal_id, const literalid_t value) {
+        literalid_t* const variables = variables_.data();
+        const literalid_t literal = literal_t::resolve_compress(variables, literal_id);
+        const literalid_t other = literal_t::resolve_compress(variables, value);
+        if (!literal_t__is_variable(literal) || !literal_t__is_variable(other)) {
+            // assigned in the meantime; the optimizer derives the rest
+            return true;
+        } else if (literal_t__is_same_variable(literal, other)) {
+            return literal == other;
+        } else if (literal > other) {
+            variables[literal_t__variable_id(literal)] = literal_t__negated_onlyif(other, literal_t__is_negation(literal));
+        } else {
+            variables[literal_t__variable_id(other)] = literal_t__negated_onlyif(literal, literal_t__is_negation(other));
+        };
+        equivalent_size_++;
+        return true;
+    };
+
+    bool CnfLiteralProber::probe_literals() {
+        CnfUnitPropagator propagator(variables_, clauses_data_);
+        bool result = true;
+        container_offset_t offset = 0;
+        while (result && offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause)) {
+                result = propagator.append(offset);
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        result = result && propagator.propagate();
+
+        std::vector<variableid_t> candidates;
+        if (result) {
+            collect_candidates(candidates);
+        };
+
+        // implications of both values, the latter ones are marked by literal
+        std::vector<literalid_t> implied0;
+        std::vector<literalid_t> implied1;
+        std::vector<bool> b_implied1((variables_.size() + 1) << 1, false);
+        std::vector<std::pair<literalid_t, literalid_t>> equivalences;
+        propagation_effort_ = CnfEffort(get_cnf_effort_limits().propagations, CNF_PROBING_PROPAGATIONS_MAX);
+
+        for (auto i = 0; result && i < candidates.size() && probed_size_ < CNF_PROBING_VARIABLES_MAX &&
+             !propagation_effort_.is_exhausted(); i++) {
+            const variableid_t variable_id = candidates[i];
+            if (variables_.data()[variable_id] != variable_t__literal_id(variable_id)) {
+                continue;
+            };
+            probed_size_++;
+
+            const literalid_t literal_id = variable_t__literal_id(variable_id);
+            const bool b_result1 = propagator.probe(literal_id, implied1);
+            propagation_effort_.spend(implied1.size());
+            if (!b_result1) {
+                failed_size_++;
+                result = propagator.assign_propagate(literal_t__negated(literal_id));
+                continue;
+            };
+            const bool b_result0 = propagator.probe(literal_t__negated(literal_id), implied0);
+            propagation_effort_.spend(implied0.size());
+            if (!b_result0) {
+                failed_size_++;
+                result = propagator.assign_propagate(literal_id);
+                continue;
+            };
+
+            for (auto literal: implied1) {
+                b_implied1[literal] = true;
+            };
+            for (auto j = 1; result && j < implied0.size(); j++) {
+                const literalid_t literal = implied0[j];
+                if (b_implied1[literal]) {
+                    // implied1 is not valid after assignment; the literal is assigned once anyway
+                    if (literal_t__is_variable(literal_t__lookup(variables_.data(), literal))) {
+                        backbone_size_++;
+                        result = propagator.assign_propagate(literal);
+                    };
+                } else if (b_implied1[literal_t__negated(literal)]) {
+                    equivalences.push_back({literal, literal_t__negated(literal_id)});
+                };
+            };
+            for (auto literal: implied1) {
+                b_implied1[literal] = false;
+            };
+        };
+
+        if (!result) {
+            if (propagator.conflict_offset() != CONTAINER_END) {
+                __print_conflict(variables_.data(), _clauses_offset_clause(clauses_data_, propagator.conflict_offset()));
+            };
+            return false;
+        };
+
+        // equivalences are applied once the propagator is not used anymore
+        for (auto it: equivalences) {
+            if (!assign_equivalent(it.first, it.second)) {
+                return false;
+            };
+        };
+        return true;
+    };
+
+    bool CnfLiteralProber::execute() {
+        return execute(true, fpmOriginal);
+    };
+
+    bool CnfLiteralProber::execute(const bool b_reindex_variables, const FormulaProcessingMode mode) {
+        const bool result = probe_literals();
+        std::cout << "Probing: " << std::dec << probed_size_ << " variable(s), ";
+        std::cout << failed_size_ << " failed, " << backbone_size_ << " backbone, ";
+        std::cout << equivalent_size_ << " equivalent literal(s), ";
+        propagation_effort_.print(std::cout, "propagation(s)");
+        std::cout << std::endl;
+        return result && CnfOptimizer::execute(b_reindex_variables, mode);
+    };
+
+};
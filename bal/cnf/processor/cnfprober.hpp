@@ -0,0 +1,64 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfprober_hpp
+#define cnfprober_hpp
+
+#include <string>
+#include "cnfoptimizer.hpp"
+
+namespace bal {
+
+    // failed literal probing
+    // each candidate variable is assigned 0 and 1 in turn and the assignment is propagated;
+    //   if one value leads to a conflict, the variable is assigned the other one;
+    //   literals implied by both values are assigned 1 (backbone);
+    //   literals implied by one value and negated by the other one are equivalent to the variable
+    // candidates are unassigned variables with the most binary clause members first,
+    // optionally limited to the variables of the named variable
+    // the resulting assignments are passed to the optimizer as if they were specified up front
+    class CnfLiteralProber: public CnfOptimizer {
+    protected:
+        // effort limits: number of probed variables and of literals assigned while probing
+        // unless the propagations budget is specified
+        static constexpr size_t CNF_PROBING_VARIABLES_MAX = 1 << 16;
+        static constexpr size_t CNF_PROBING_PROPAGATIONS_MAX = 1 << 26;
+
+    private:
+        const std::string variable_name_;
+
+        size_t probed_size_ = 0;
+        size_t failed_size_ = 0;
+        size_t backbone_size_ = 0;
+        size_t equivalent_size_ = 0;
+        CnfEffort propagation_effort_;
+
+        inline void collect_candidates(std::vector<variableid_t>& candidates) const;
+        inline bool assign_equivalent(const literalid_t literal_id, const literalid_t value);
+
+    protected:
+        // returns false if the formula is found unsatisfiable
+        bool probe_literals();
+
+    public:
+        CnfLiteralProber(Cnf& cnf, VariablesArray& variables, const std::string& variable_name = ""):
+            CnfOptimizer(cnf, variables), variable_name_(variable_name) {};
+
+        bool execute() override;
+        bool execute(const bool b_reindex_variables, const FormulaProcessingMode mode) override;
+    };
+
+    inline bool probe_literals(Cnf& cnf, const bool b_reindex_variables, const FormulaProcessingMode mode,
+                               const std::string& variable_name) {
+        VariablesArray variables(cnf.variables_size(), 1);
+        variables.assign_sequence();
+        return CnfLiteralProber(cnf, variables, variable_name).execute(b_reindex_variables, mode);
+    };
+
+};
+
+#endif /* cnfprober_hpp */
@@ -41,6 +41,23 @@ namespace bal {
         // where the check prevents unbounded recursion
         container_offset_t processed_offset_ = 0;
         
+        // memory size of clauses excluded beyond the transaction bound, maintained by descendants
+        // process_clauses compacts the clauses once it exceeds the below share of mutable clauses
+        // CALLER_T::is_clause_obsolete decides which excluded clauses are dropped
+        container_size_t excluded_size_ = 0;
+        ContainerOffsetsMap compaction_map_;
+        bool b_compaction_enabled_ = true;
+        
+        // excluded clauses must take at least 1/2^CNF_COMPACTION_RATIO_SHIFT of mutable clauses memory
+        // and CNF_COMPACTION_MIN_SIZE words to trigger compaction
+        static constexpr unsigned CNF_COMPACTION_RATIO_SHIFT = 1;
+        static constexpr container_size_t CNF_COMPACTION_MIN_SIZE = 1 << 16;
+        
+        // a formula on the heap is moved into an address range reserved for
+        // CNF_CLAUSES_RESERVE_FACTOR times its clauses memory and at least CNF_CLAUSES_RESERVE_MIN_SIZE words
+        static constexpr container_size_t CNF_CLAUSES_RESERVE_FACTOR = 8;
+        static constexpr container_size_t CNF_CLAUSES_RESERVE_MIN_SIZE = 1 << 24;
+        
     protected:
         // DEBUG method
         // outputs processed clauses only
@@ -69,6 +86,26 @@ namespace bal {
          */
         
     protected:
+        inline bool is_compaction_due() const {
+            // compaction remaps the index, which may not be done within its transaction
+            return b_compaction_enabled_ && !clauses_index_.transaction_is_in() && excluded_size_ >= CNF_COMPACTION_MIN_SIZE &&
+                excluded_size_ >= ((cnf_.size_ - cnf_.transaction_immutable_size()) >> CNF_COMPACTION_RATIO_SHIFT);
+        };
+        
+        // drops obsolete excluded clauses appended since the transaction began, moving the remaining ones down
+        // updates offsets of the processed clauses index and processed_offset_
+        // returns the new offset of the first clause at or after the supplied offset
+        template<typename CALLER_T>
+        inline container_offset_t compact_clauses(const CALLER_T* const p_caller, const container_offset_t offset) {
+            clauses_.compact([p_caller](const uint32_t* const p_clause) {
+                return p_caller->is_clause_obsolete(p_clause);
+            }, compaction_map_);
+            clauses_index_.remap(compaction_map_);
+            processed_offset_ = compaction_map_.lower_bound(processed_offset_);
+            excluded_size_ = 0;
+            return compaction_map_.lower_bound(offset);
+        };
+        
         // determine if the binary variable is used in at least one clause
         inline bool is_variable_used(const variableid_t variable_id) const {
             return clauses_index_.iterate_const<CnfProcessor, bool, &CnfProcessor::is_clause_included, false>(this, variable_id);
@@ -84,46 +121,54 @@ namespace bal {
                 // make a sorted list of all used container offsets
                 // then basically d the same thing as unsafe while limiting to these offsets
                 std::vector<container_offset_t> offsets;
+                offsets.reserve(cnf_.clauses_size());
                 for (auto it: cnf_.clauses()) {
                     offsets.push_back((container_offset_t)(it - clauses_data_));
                 };
                 std::sort(offsets.begin(), offsets.end());
                 // rollback after collecting the offsets
                 cnf_.rollback(0, 0, 0);
-                // add the clauses back
+                // add the clauses back, index them at once
+                clauses_.bulk_load_begin();
                 for (auto i = 0; i < offsets.size(); i++) {
                     uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offsets[i]);
                     if ((p_caller->*p_update_clause)(p_clause)) {
-                        Cnf::insertion_point_t insertion_point;
-                        __insertion_point_t_init(insertion_point);
-                        clauses_.append<false>(p_clause, insertion_point);
+                        clauses_.bulk_load_append(p_clause);
                     };
                 };
+                // released before the commit allocates its own scratch
+                std::vector<container_offset_t>().swap(offsets);
+                clauses_.bulk_load_commit();
             } else {
                 const container_size_t original_size_ = cnf_.size_;
                 cnf_.rollback(0, 0, 0);
+                clauses_.bulk_load_begin();
                 uint32_t offset = 0;
                 while (offset < original_size_) {
                     uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
                     // p_clause size may change
                     const clause_size_t clause_size = _clause_size(p_clause);
                     if ((p_caller->*p_update_clause)(p_clause)) {
-                        Cnf::insertion_point_t insertion_point;
-                        __insertion_point_t_init(insertion_point);
-                        clauses_.append<false>(p_clause, insertion_point);
+                        clauses_.bulk_load_append(p_clause);
                     };
                     _clauses_offset_size_next(offset, clause_size);
                 };
+                clauses_.bulk_load_commit();
             };
         };
         
         // process each clause, remove it if the processing method returns false
+        // starting from a clause other than the first one, clauses before it must be in the index already
+        // within an index transaction, the index is kept even if there are no clauses before the first one
         template<typename CALLER_T, processor_result_t (CALLER_T::*p_process_clause)(uint32_t* const p_clause)>
-        inline processor_result_t process_clauses(CALLER_T* const p_caller) {
-            clauses_index_.reset(0, 0);
+        inline processor_result_t process_clauses(CALLER_T* const p_caller, const container_offset_t first_offset = 0) {
+            if (first_offset == 0 && !clauses_index_.transaction_is_in()) {
+                clauses_index_.reset(0, 0);
+            };
+            excluded_size_ = 0;
             processor_result_t result = erUndetermined;
             
-            uint32_t offset = 0;
+            uint32_t offset = first_offset;
             while (offset < cnf_.size_) {
                 uint32_t* p_clause = _clauses_offset_clause(clauses_data_, offset);
                 // p_clause size may change
@@ -136,8 +181,10 @@ namespace bal {
                         result = erConflict;
                         break;
                     } else {
-                        // the pointer may become invalid
+#ifndef CONTAINER_VIRTUAL_MEMORY
+                        // the clauses may move where an address range cannot be reserved for them
                         p_clause = _clauses_offset_clause(clauses_data_, offset);
+#endif
                         if (_clause_is_included(p_clause)) {
                             // append processed clause to the index if included
                             for (auto i = 0; i < _clause_size(p_clause); i++) {
@@ -148,21 +195,44 @@ namespace bal {
                 };
                 
                 _clauses_offset_size_next(offset, clause_size);
+                
+                // keeps memory bounded and iteration dense while changed clauses are appended
+                if (is_compaction_due()) {
+                    offset = compact_clauses(p_caller, offset);
+                };
             };
             
             return result;
         };
         
+    public:
+        // an excluded clause may be dropped by compaction unless a descendant needs it
+        inline bool is_clause_obsolete(const uint32_t* const p_clause) const { return true; };
+        
     private:
         inline processor_result_t process_clause_build_index(uint32_t* const p_clause) { return erUndetermined; };
         
     protected:
+        // drops all clauses so that they can be bulk loaded anew
+        inline void clear_clauses() {
+            _assert_level_1(!cnf_.transaction_is_in());
+            cnf_.rollback(0, 0, 0);
+        };
+        
         void build_clauses_index() {
             process_clauses<CnfProcessor, &CnfProcessor::process_clause_build_index>(this);
         };
         
     public:
-        CnfProcessor(Cnf& cnf): cnf_(cnf), clauses_(cnf_), clauses_data_(cnf_.data_), clauses_size_(cnf_.size_), named_variables_(cnf_.get_named_variables_()), clauses_index_(cnf_.p_container_) {};
+        // clause pointers are kept while clauses are appended, see process_clauses
+        CnfProcessor(Cnf& cnf): cnf_(cnf), clauses_(cnf_), clauses_data_(cnf_.data_), clauses_size_(cnf_.size_), named_variables_(cnf_.get_named_variables_()), clauses_index_(cnf_.p_container_) {
+#ifdef CONTAINER_VIRTUAL_MEMORY
+            if (!cnf_.is_address_stable()) {
+                const container_size_t size = std::max(cnf_.size_, CNF_CLAUSES_RESERVE_MIN_SIZE / CNF_CLAUSES_RESERVE_FACTOR);
+                cnf_.set_clauses_allocation(caVirtual, (container_size_t)std::min((size_t)size * CNF_CLAUSES_RESERVE_FACTOR, (size_t)CONTAINER_SIZE_MAX));
+            };
+#endif
+        };
         
         virtual bool execute() = 0;
     };
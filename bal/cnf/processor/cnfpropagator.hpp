@@ -0,0 +1,426 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfpropagator_hpp
+#define cnfpropagator_hpp
+
+#include <vector>
+#include "assertlevels.hpp"
+#include "container.hpp"
+#include "variablesarray.hpp"
+#include "cnfclausescontainer.hpp"
+
+namespace bal {
+
+    // UNIT PROPAGATION
+    // assigns variable values implied by unit clauses through the variables array
+    // literals are resolved against the variables array, the original clauses are never changed
+    //   binary clauses: lists of implications for each literal, followed when the literal becomes 0
+    //   aggregated clauses of 3 or 4 variables: two unassigned variables are watched;
+    //     the clause is visited once either of them is assigned and its flags are reduced
+    //     by all assigned variables; it is unit once a single variable remains
+    //   longer clauses: two watched literals, a clause is only visited when one of them becomes 0;
+    //     the blocker is another literal of the clause, the clause is skipped while the blocker is 1
+    // all lists are linked through their items so that building does not allocate per literal
+    // implications and watches of aggregated clauses refer to the original clauses
+    // probing assigns a literal temporarily; lists are only shortened by assignments which are kept
+    // the original clause implying each value is its reason, conflicts are explained through reasons
+    //
+    // LONG CLAUSES MEMORY STRUCTURE
+    //  |<--------- 32 bit --------->|
+    //  |============================|
+    //  | original clause offset     |
+    //  | size                       |
+    //  | watched literal 0          |
+    //  | watched literal 1          |
+    //  | other literals             |
+    //  |============================|
+    class CnfUnitPropagator {
+    private:
+        // an item of the list of a literal or a variable
+        struct watch_t {
+            // long clause offset or original clause offset
+            container_offset_t offset;
+            // blocker of a long clause, implied literal of a binary clause,
+            // the other watched variable of an aggregated clause
+            literalid_t literal;
+            container_offset_t next;
+        };
+
+        literalid_t* const variables_;
+        const uint32_t* const clauses_data_;
+
+        Container<literalid_t> clauses_;
+        Container<watch_t> watches_;
+        Container<watch_t> implications_;
+        Container<watch_t> aggregates_;
+        // first items of lists; watches and implications by literal id, aggregates by variable id
+        Container<container_offset_t> watches_first_;
+        Container<container_offset_t> implications_first_;
+        Container<container_offset_t> aggregates_first_;
+
+        // literals assigned 1 in order of assignment; those before trail_head_ are propagated
+        std::vector<literalid_t> trail_;
+        // original clause offset by variable id, CONTAINER_END for values assigned from outside
+        std::vector<container_offset_t> reasons_;
+        size_t trail_head_ = 0;
+
+        container_offset_t conflict_offset_ = CONTAINER_END;
+        // true while a literal is being probed
+        bool b_probing_ = false;
+
+        inline bool is_literal_1(const literalid_t literal_id) const {
+            return literal_t__lookup(variables_, literal_id) == LITERAL_CONST_1;
+        };
+
+        inline bool is_literal_0(const literalid_t literal_id) const {
+            return literal_t__lookup(variables_, literal_id) == LITERAL_CONST_0;
+        };
+
+        inline static void link(Container<watch_t>& items, Container<container_offset_t>& first,
+                                const container_offset_t index, const container_offset_t offset, const literalid_t literal) {
+            items.append({offset, literal, first.data_[index]}, 1);
+            first.data_[index] = items.size_ - 1;
+        };
+
+        // returns false if the literal is 0 already
+        inline bool assign(const literalid_t literal_id, const container_offset_t original_offset) {
+            const literalid_t value = literal_t__lookup(variables_, literal_id);
+            if (literal_t__is_variable(value)) {
+                variables_[literal_t__variable_id(literal_id)] = literal_t__constant(literal_t__is_unnegated(literal_id));
+                reasons_[literal_t__variable_id(literal_id)] = original_offset;
+                trail_.push_back(literal_id);
+                return true;
+            } else if (value == LITERAL_CONST_1) {
+                return true;
+            } else {
+                conflict_offset_ = original_offset;
+                return false;
+            };
+        };
+
+        // reduces flags of the aggregated clause by assigned variables
+        // literals receives resolved unassigned literals in reverse order, the flags refer to them in direct order
+        // returns their number or CLAUSE_SIZE_MAX + 1 if the clause has to be skipped
+        inline clause_size_t reduce(const uint32_t* const p_clause, clause_flags_t& flags, literalid_t* const literals) const {
+            clause_size_t size = 0;
+            flags = _clause_flags(p_clause);
+            for (auto i = _clause_size(p_clause); i > 0 && flags != 0; i--) {
+                const literalid_t value = literal_t::resolve(variables_, _clause_literal(p_clause, i - 1));
+                if (literal_t__is_constant(value)) {
+                    ca_flags_reduce(flags, i - 1, value);
+                } else if (literal_t__is_variable(value)) {
+                    literals[size++] = value;
+                } else {
+                    return CLAUSE_SIZE_MAX + 1;
+                };
+            };
+            return size;
+        };
+
+        inline static bool is_variable_repeated(const literalid_t* const literals, const clause_size_t size) {
+            for (auto i = 1; i < size; i++) {
+                for (auto j = 0; j < i; j++) {
+                    if (literal_t__is_same_variable(literals[i], literals[j])) {
+                        return true;
+                    };
+                };
+            };
+            return false;
+        };
+
+        // the remaining literal of an aggregated clause; 0b01 stands for the clause of its negation
+        inline bool assign_reduced(const literalid_t literal_id, const clause_flags_t flags, const container_offset_t original_offset) {
+            if (flags == 0b11) {
+                conflict_offset_ = original_offset;
+                return false;
+            };
+            return assign(literal_t__negated_onlyif(literal_id, flags == 0b01), original_offset);
+        };
+
+        inline bool append_implications(const literalid_t literal0, const literalid_t literal1, const clause_flags_t flags, const container_offset_t original_offset) {
+            for (auto bits = 0; bits < 4; bits++) {
+                if (flags & (1 << bits)) {
+                    const literalid_t l0 = literal_t__negated_onlyif(literal0, (bits & 0b01) == 0);
+                    const literalid_t l1 = literal_t__negated_onlyif(literal1, (bits & 0b10) == 0);
+                    link(implications_, implications_first_, l0, original_offset, l1);
+                    link(implications_, implications_first_, l1, original_offset, l0);
+                };
+            };
+            return true;
+        };
+
+        inline bool append_aggregated(const uint32_t* const p_clause, const container_offset_t original_offset) {
+            clause_flags_t flags;
+            literalid_t literals[4];
+            const clause_size_t size = reduce(p_clause, flags, literals);
+            if (flags == 0 || size > CLAUSE_SIZE_MAX) {
+                return true;
+            } else if (size == 0) {
+                conflict_offset_ = original_offset;
+                return false;
+            } else if (size == 1) {
+                return assign_reduced(literals[0], flags, original_offset);
+            } else if (is_variable_repeated(literals, size)) {
+                // a variable and its equivalent; left to the optimizer
+                return true;
+            } else if (size == 2) {
+                return append_implications(literals[1], literals[0], flags, original_offset);
+            } else {
+                const variableid_t variable0 = literal_t__variable_id(literals[0]);
+                const variableid_t variable1 = literal_t__variable_id(literals[1]);
+                link(aggregates_, aggregates_first_, variable0, original_offset, variable_t__literal_id(variable1));
+                link(aggregates_, aggregates_first_, variable1, original_offset, variable_t__literal_id(variable0));
+                return true;
+            };
+        };
+
+        // literals must be resolved already, without constants, duplicates or complementary pairs
+        inline bool append_resolved(const literalid_t* const literals, const clause_size_t size, const container_offset_t original_offset) {
+            if (size == 0) {
+                conflict_offset_ = original_offset;
+                return false;
+            } else if (size == 1) {
+                return assign(literals[0], original_offset);
+            } else if (size == 2) {
+                link(implications_, implications_first_, literals[0], original_offset, literals[1]);
+                link(implications_, implications_first_, literals[1], original_offset, literals[0]);
+            } else {
+                const container_offset_t offset = clauses_.size_;
+                clauses_.reserve(size + 2);
+                clauses_.data_[clauses_.size_++] = original_offset;
+                clauses_.data_[clauses_.size_++] = size;
+                std::copy(literals, literals + size, clauses_.data_ + clauses_.size_);
+                clauses_.size_ += size;
+                link(watches_, watches_first_, literals[0], offset, literals[1]);
+                link(watches_, watches_first_, literals[1], offset, literals[0]);
+            };
+            return true;
+        };
+
+        // resolves literals against the variables array, drops the clause if it is satisfied
+        inline bool append_unaggregated(const uint32_t* const p_clause, const container_offset_t original_offset) {
+            const clause_size_t size = _clause_size(p_clause);
+            literalid_t literals[size];
+            clause_size_t new_size = 0;
+            for (auto i = 0; i < size; i++) {
+                const literalid_t value = literal_t::resolve(variables_, _clause_literal(p_clause, i));
+                if (literal_t__is_unassigned(value) || literal_t__is_constant_1(value)) {
+                    return true;
+                } else if (literal_t__is_variable(value)) {
+                    clause_size_t j = 0;
+                    while (j < new_size && !literal_t__is_same_variable(literals[j], value)) {
+                        j++;
+                    };
+                    if (j == new_size) {
+                        literals[new_size++] = value;
+                    } else if (literals[j] != value) {
+                        return true;
+                    };
+                };
+            };
+            return append_resolved(literals, new_size, original_offset);
+        };
+
+        // visits aggregated clauses watching the assigned variable
+        inline bool propagate_aggregates(const variableid_t variable_id) {
+            container_offset_t* p_offset = aggregates_first_.data_ + variable_id;
+            while (*p_offset != CONTAINER_END) {
+                const container_offset_t watch_offset = *p_offset;
+                watch_t& watch = aggregates_.data_[watch_offset];
+                clause_flags_t flags;
+                literalid_t literals[4];
+                const clause_size_t size = reduce(_clauses_offset_clause(clauses_data_, watch.offset), flags, literals);
+                if (flags == 0 || size > CLAUSE_SIZE_MAX) {
+                    // satisfied for good unless probing
+                    if (b_probing_) {
+                        p_offset = &watch.next;
+                    } else {
+                        *p_offset = watch.next;
+                    };
+                    continue;
+                } else if (size == 0) {
+                    conflict_offset_ = watch.offset;
+                    return false;
+                } else if (size == 1) {
+                    if (!assign_reduced(literals[0], flags, watch.offset)) {
+                        return false;
+                    };
+                    if (b_probing_) {
+                        p_offset = &watch.next;
+                    } else {
+                        *p_offset = watch.next;
+                    };
+                    continue;
+                };
+
+                // move the watch to another unassigned variable
+                const variableid_t other_variable_id = literal_t__variable_id(watch.literal);
+                clause_size_t i = 0;
+                while (i < size && literal_t__variable_id(literals[i]) == other_variable_id) {
+                    i++;
+                };
+                if (i < size) {
+                    const variableid_t new_variable_id = literal_t__variable_id(literals[i]);
+                    *p_offset = watch.next;
+                    watch.next = aggregates_first_.data_[new_variable_id];
+                    aggregates_first_.data_[new_variable_id] = watch_offset;
+                } else {
+                    p_offset = &watch.next;
+                };
+            };
+            return true;
+        };
+
+        // visits long clauses watching the literal which became 0
+        inline bool propagate_watches(const literalid_t literal_0) {
+            // watches moved to other literals are unlinked from the list
+            container_offset_t* p_offset = watches_first_.data_ + literal_0;
+            while (*p_offset != CONTAINER_END) {
+                const container_offset_t watch_offset = *p_offset;
+                watch_t& watch = watches_.data_[watch_offset];
+                if (is_literal_1(watch.literal)) {
+                    p_offset = &watch.next;
+                    continue;
+                };
+
+                literalid_t* const p_clause = clauses_.data_ + watch.offset;
+                literalid_t* const literals = p_clause + 2;
+                if (literals[0] == literal_0) {
+                    std::swap(literals[0], literals[1]);
+                };
+                _assert_level_2(literals[1] == literal_0);
+                if (literals[0] != watch.literal && is_literal_1(literals[0])) {
+                    watch.literal = literals[0];
+                    p_offset = &watch.next;
+                    continue;
+                };
+
+                // look for a replacement of the watched literal
+                const clause_size_t size = p_clause[1];
+                clause_size_t k = 2;
+                while (k < size && is_literal_0(literals[k])) {
+                    k++;
+                };
+                if (k < size) {
+                    std::swap(literals[1], literals[k]);
+                    *p_offset = watch.next;
+                    watch.literal = literals[0];
+                    watch.next = watches_first_.data_[literals[1]];
+                    watches_first_.data_[literals[1]] = watch_offset;
+                    continue;
+                };
+
+                // the clause is unit
+                if (!assign(literals[0], p_clause[0])) {
+                    return false;
+                };
+                p_offset = &watch.next;
+            };
+            return true;
+        };
+
+    public:
+        // clauses_data must not move while the propagator is used
+        CnfUnitPropagator(VariablesArray& variables, const uint32_t* const clauses_data):
+            variables_(variables.data()), clauses_data_(clauses_data), reasons_(variables.size(), CONTAINER_END) {
+            watches_first_.append(CONTAINER_END, (variables.size() + 1) << 1);
+            implications_first_.append(CONTAINER_END, (variables.size() + 1) << 1);
+            aggregates_first_.append(CONTAINER_END, variables.size());
+        };
+
+        // returns false on conflict, see conflict_offset
+        inline bool append(const container_offset_t original_offset) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, original_offset);
+            return _clause_is_aggregated(p_clause) ?
+                append_aggregated(p_clause, original_offset) : append_unaggregated(p_clause, original_offset);
+        };
+
+        // propagates all assignments made so far; returns false on conflict, see conflict_offset
+        inline bool propagate() {
+            while (trail_head_ < trail_.size()) {
+                const literalid_t literal_0 = literal_t__negated(trail_[trail_head_++]);
+
+                container_offset_t offset = implications_first_.data_[literal_0];
+                while (offset != CONTAINER_END) {
+                    const watch_t& implication = implications_.data_[offset];
+                    if (!assign(implication.literal, implication.offset)) {
+                        return false;
+                    };
+                    offset = implication.next;
+                };
+
+                if (!propagate_aggregates(literal_t__variable_id(literal_0)) || !propagate_watches(literal_0)) {
+                    return false;
+                };
+            };
+            return true;
+        };
+
+        // assigns the literal for good and propagates; returns false on conflict
+        inline bool assign_propagate(const literalid_t literal_id) {
+            return assign(literal_id, CONTAINER_END) && propagate();
+        };
+
+        // assigns the literal temporarily and propagates, all assignments are undone afterwards
+        // implied receives the literals assigned 1 including the probed one
+        // all preceding assignments must be propagated; returns false on conflict
+        inline bool probe(const literalid_t literal_id, std::vector<literalid_t>& implied) {
+            _assert_level_1(trail_head_ == trail_.size());
+            const size_t trail_size = trail_.size();
+            b_probing_ = true;
+            const bool result = assign(literal_id, CONTAINER_END) && propagate();
+            b_probing_ = false;
+            implied.assign(trail_.begin() + trail_size, trail_.end());
+            for (auto i = trail_size; i < trail_.size(); i++) {
+                const variableid_t variable_id = literal_t__variable_id(trail_[i]);
+                variables_[variable_id] = variable_t__literal_id(variable_id);
+            };
+            trail_.resize(trail_size);
+            trail_head_ = trail_size;
+            conflict_offset_ = CONTAINER_END;
+            return result;
+        };
+
+        // offset of the original clause which is 0 under the assignment
+        inline container_offset_t conflict_offset() const { return conflict_offset_; };
+
+        // number of variables assigned by the propagator
+        inline size_t assigned_size() const { return trail_.size(); };
+
+        // variables assigned from outside, before or by assign_propagate, the conflict follows from
+        // those are found walking the reasons back from the conflict clause
+        // the variables array must hold constants only, not equivalences; returns false if there is no conflict clause
+        inline bool explain(std::vector<variableid_t>& inputs) const {
+            inputs.clear();
+            if (conflict_offset_ == CONTAINER_END) {
+                return false;
+            };
+            std::vector<bool> visited(reasons_.size(), false);
+            std::vector<container_offset_t> offsets(1, conflict_offset_);
+            while (!offsets.empty()) {
+                const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offsets.back());
+                offsets.pop_back();
+                for (auto i = 0; i < _clause_size(p_clause); i++) {
+                    const variableid_t variable_id = literal_t__variable_id(_clause_literal(p_clause, i));
+                    if (!visited[variable_id] && literal_t__is_constant(variables_[variable_id])) {
+                        visited[variable_id] = true;
+                        if (reasons_[variable_id] == CONTAINER_END) {
+                            inputs.push_back(variable_id);
+                        } else {
+                            offsets.push_back(reasons_[variable_id]);
+                        };
+                    };
+                };
+            };
+            return true;
+        };
+    };
+
+};
+
+#endif /* cnfpropagator_hpp */
@@ -0,0 +1,84 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#include <iostream>
+#include "cnfscheduler.hpp"
+#include "cnfeffort.hpp"
+
+namespace bal {
+
+    constexpr uint32_t CnfPassScheduler::CNF_PASS_ROUNDS_MAX;
+
+    // clause hashes are added up since the index may list the same clauses in another order
+    uint64_t cnf_signature(const Cnf& cnf) {
+        uint64_t result = cnf.variables_size();
+        for (auto it: cnf.clauses()) {
+            const uint32_t* const p_clause = _clauses_offset_item_clause(it);
+            if (_clause_is_included(p_clause)) {
+                uint64_t hash = _clause_header(p_clause);
+                for (auto i = 0; i < _clause_size(p_clause); i++) {
+                    hash = (hash ^ _clause_literal(p_clause, i)) * 0x100000001B3;
+                };
+                result += hash ^ (hash >> 29);
+            };
+        };
+        return result;
+    };
+
+    bool CnfPassScheduler::execute(Cnf& cnf, const bool b_reindex_variables, const FormulaProcessingMode mode) {
+        for (auto& pass: passes_) {
+            pass.b_executed = false;
+        };
+
+        uint64_t signature = cnf_signature(cnf);
+        uint32_t rounds = 0;
+        bool b_changed = true;
+        bool b_time_out = false;
+        while (b_changed && !b_time_out && rounds < rounds_max_) {
+            b_changed = false;
+            rounds++;
+            for (auto& pass: passes_) {
+                if (pass.b_executed && pass.signature == signature) {
+                    continue;
+                };
+                uint32_t runs = 0;
+                bool b_pass_changed = true;
+                while (b_pass_changed && runs < (pass.b_cheap ? rounds_max_ : 1)) {
+                    b_time_out = is_cnf_effort_time_out();
+                    if (b_time_out) {
+                        break;
+                    };
+                    if (!pass.pass(cnf, b_reindex_variables, mode)) {
+                        return false;
+                    };
+                    runs++;
+                    const uint64_t new_signature = cnf_signature(cnf);
+                    b_pass_changed = (new_signature != signature);
+                    b_changed = b_changed || b_pass_changed;
+                    signature = new_signature;
+                    pass.signature = signature;
+                    pass.b_executed = true;
+                };
+                if (b_time_out) {
+                    break;
+                };
+            };
+        };
+
+        if (rounds_max_ > 1) {
+            std::cout << "Passes: " << std::dec << rounds << " round(s)";
+            if (b_time_out) {
+                std::cout << " (out of time)";
+            } else if (b_changed) {
+                std::cout << " (out of rounds)";
+            };
+            std::cout << std::endl;
+        };
+        return true;
+    };
+
+};
@@ -0,0 +1,63 @@
+//
+//  Boolean Algebra Library (BAL)
+//  https://cgen.sophisticatedways.net
+//  Copyright © 2018-2020 Volodymyr Skladanivskyy. All rights reserved.
+//  Published under terms of MIT license.
+//
+
+#ifndef cnfscheduler_hpp
+#define cnfscheduler_hpp
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "cnf.hpp"
+
+namespace bal {
+
+    // a pass processes the formula as a whole and leaves it consistent, named variables included
+    // returns false if the formula is found unsatisfiable
+    typedef std::function<bool(Cnf& cnf, const bool b_reindex_variables, const FormulaProcessingMode mode)> cnf_pass_t;
+
+    // runs the registered passes in their order, round after round, until none of them changes the formula,
+    // the rounds limit is reached or the time limit runs out
+    // a pass changes the formula if its signature, i.e. variables and clauses, differs afterwards;
+    // a pass is skipped while the formula is the same as when it last finished;
+    // a cheap pass is repeated at once while it changes the formula, an expensive one runs once per round
+    class CnfPassScheduler {
+    private:
+        typedef struct CnfPass {
+            std::string name;
+            cnf_pass_t pass;
+            bool b_cheap;
+            // the formula signature when the pass last finished
+            uint64_t signature;
+            bool b_executed;
+        } CnfPass;
+
+        std::vector<CnfPass> passes_;
+        uint32_t rounds_max_;
+
+    public:
+        // the default for rounds_max == 0
+        static constexpr uint32_t CNF_PASS_ROUNDS_MAX = 16;
+
+        CnfPassScheduler(const uint32_t rounds_max = 0):
+            rounds_max_(rounds_max == 0 ? CNF_PASS_ROUNDS_MAX : rounds_max) {};
+
+        inline void register_pass(const std::string& name, const cnf_pass_t& pass, const bool b_cheap) {
+            passes_.push_back({ name, pass, b_cheap, 0, false });
+        };
+
+        inline bool is_empty() const { return passes_.empty(); };
+
+        // returns false if the formula is found unsatisfiable
+        bool execute(Cnf& cnf, const bool b_reindex_variables, const FormulaProcessingMode mode);
+    };
+
+    // order independent hash of the included clauses and the number of variables
+    uint64_t cnf_signature(const Cnf& cnf);
+
+};
+
+#endif /* cnfscheduler_hpp */
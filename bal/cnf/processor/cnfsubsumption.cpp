@@ -9,6 +9,195 @@
 
 namespace bal {
     
+    // signature of the clause variables; a clause may only subsume another one
+    // if its signature bits are a subset of the other's
+    inline uint64_t clause_signature(const literalid_t* const literals, const clause_size_t size) {
+        uint64_t signature = 0;
+        for (auto i = 0; i < size; i++) {
+            signature |= (uint64_t)1 << (literal_t__variable_id(literals[i]) & 63);
+        };
+        return signature;
+    };
+    
+    inline void CnfSubsumptionOptimizer::append_long_clause(const container_offset_t offset) {
+        const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+        const uint32_t long_index = (uint32_t)long_offsets_.size();
+        long_offsets_.push_back(offset);
+        long_signatures_.push_back(clause_signature(_clause_literals(p_clause), _clause_size(p_clause)));
+        for (auto i = 0; i < _clause_size(p_clause); i++) {
+            long_occurrences_[_clause_variable(p_clause, i)].push_back(long_index);
+        };
+    };
+    
+    // checks the clause against the long clause, both sorted by variables
+    // returns the long clause size if it is subsumed,
+    // index of its literal to be removed if it is strengthened by self-subsuming resolution,
+    // CLAUSE_SIZE_MAX otherwise
+    inline clause_size_t CnfSubsumptionOptimizer::subsume_long_clause(const literalid_t* const literals, const clause_size_t size,
+                                                                      const uint32_t* const p_long) {
+        const clause_size_t long_size = _clause_size(p_long);
+        const literalid_t* const long_literals = _clause_literals(p_long);
+        clause_size_t result = long_size;
+        clause_size_t j = 0;
+        for (auto i = 0; i < size; i++) {
+            const variableid_t variable_id = literal_t__variable_id(literals[i]);
+            while (j < long_size && literal_t__variable_id(long_literals[j]) < variable_id) {
+                j++;
+            };
+            if (j == long_size || literal_t__variable_id(long_literals[j]) != variable_id) {
+                return CLAUSE_SIZE_MAX;
+            };
+            if (long_literals[j] != literals[i]) {
+                // only one literal may be complemented
+                if (result != long_size) {
+                    return CLAUSE_SIZE_MAX;
+                };
+                result = j;
+            };
+            j++;
+        };
+        return result;
+    };
+    
+    // replaces the long clause with the resolvent missing the literal
+    // an equivalent excluded clause is included again instead of appending the resolvent
+    inline void CnfSubsumptionOptimizer::strengthen_long_clause(const uint32_t long_index, const clause_size_t literal_index) {
+        uint32_t* const p_long = _clauses_offset_clause(clauses_data_, long_offsets_[long_index]);
+        const clause_size_t size = _clause_size(p_long) - 1;
+        uint32_t resolvent[_clause_size_memory_size(size)];
+        clause_flags_t flags = 0;
+        for (auto i = 0, j = 0; i < size; i++, j++) {
+            if (j == literal_index) {
+                j++;
+            };
+            _clause_literal(resolvent, i) = _clause_literal(p_long, j);
+        };
+        _clause_exclude(p_long);
+        
+        // the resolvent becomes aggregated when 4 literals remain
+        if (_clause_size_is_aggregated(size)) {
+            uint16_t bitmap = 0;
+            for (auto i = 0; i < size; i++) {
+                if (literal_t__is_unnegated(_clause_literal(resolvent, i))) {
+                    bitmap |= 0x1 << i;
+                } else {
+                    literal_t__unnegate(_clause_literal(resolvent, i));
+                };
+            };
+            flags = 0x1 << bitmap;
+        };
+        _clause_header_set(resolvent, flags, size);
+        
+        // the resolvent may subsume other clauses
+        // appended ones are processed in turn, existing ones are checked again
+        Cnf::insertion_point_t insertion_point;
+        __insertion_point_t_init(insertion_point);
+        clauses_.find(resolvent, insertion_point);
+        const container_offset_t offset = insertion_point.container_offset;
+        if (offset != CONTAINER_END && !_clauses_offset_is_included(clauses_data_, offset)) {
+            _clause_header_set(_clauses_offset_clause(clauses_data_, offset), flags, size);
+            subsuming_changed_.push_back(offset);
+        } else if (offset != CONTAINER_END) {
+            clauses_.append<false>(resolvent, insertion_point);
+            subsuming_changed_.push_back(offset);
+        } else {
+            clauses_.append<false>(resolvent, insertion_point);
+            if (!_clause_size_is_aggregated(size)) {
+                append_long_clause(insertion_point.container_offset);
+            };
+        };
+    };
+    
+    // checks long clauses with the least frequent variable of the given clause
+    inline void CnfSubsumptionOptimizer::process_long_subsumption(const literalid_t* const literals, const clause_size_t size) {
+        variableid_t variable_id = literal_t__variable_id(literals[0]);
+        for (auto i = 1; i < size; i++) {
+            if (long_occurrences_[literal_t__variable_id(literals[i])].size() < long_occurrences_[variable_id].size()) {
+                variable_id = literal_t__variable_id(literals[i]);
+            };
+        };
+        const uint64_t signature = clause_signature(literals, size);
+        
+        // the list may grow while strengthening
+        for (auto i = 0; i < long_occurrences_[variable_id].size() && !subsumption_effort_.is_exhausted(); i++) {
+            const uint32_t long_index = long_occurrences_[variable_id][i];
+            const container_offset_t long_offset = long_offsets_[long_index];
+            if (long_offset != subsuming_offset_ && (signature & ~long_signatures_[long_index]) == 0 &&
+                _clauses_offset_is_included(clauses_data_, long_offset)) {
+                subsumption_effort_.spend();
+                const uint32_t* const p_long = _clauses_offset_clause(clauses_data_, long_offset);
+                const clause_size_t literal_index = subsume_long_clause(literals, size, p_long);
+                if (literal_index == _clause_size(p_long)) {
+                    _clauses_offset_exclude(clauses_data_, long_offset);
+                } else if (literal_index != CLAUSE_SIZE_MAX) {
+                    strengthen_long_clause(long_index, literal_index);
+                };
+            };
+        };
+    };
+    
+    // checks each member of an aggregated clause or the long clause itself
+    inline void CnfSubsumptionOptimizer::process_long_subsumption(const container_offset_t offset) {
+        const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+        if (_clause_is_included(p_clause)) {
+            subsuming_offset_ = offset;
+            const clause_size_t size = _clause_size(p_clause);
+            // the clause may move while appending resolvents
+            literalid_t literals[size];
+            std::copy(_clause_literals(p_clause), _clause_literals(p_clause) + size, literals);
+            if (_clause_size_is_aggregated(size)) {
+                const clause_flags_t flags = _clause_flags(p_clause);
+                literalid_t member[4];
+                for (auto bitmap = 0; bitmap < (0x1 << size); bitmap++) {
+                    if ((flags & (0x1 << bitmap)) != 0) {
+                        for (auto i = 0; i < size; i++) {
+                            member[i] = literal_t__negated_onlyif(literals[i], (bitmap & (0x1 << i)) == 0);
+                        };
+                        process_long_subsumption(member, size);
+                    };
+                };
+            } else {
+                process_long_subsumption(literals, size);
+            };
+        };
+    };
+    
+    // subsumption and self-subsuming resolution of long clauses
+    // every included clause is checked in turn, including resolvents,
+    // so that each subsuming pair is found whichever of the clauses comes first
+    inline void CnfSubsumptionOptimizer::process_long_subsumption() {
+        long_occurrences_.resize(cnf_.variables_size());
+        container_offset_t offset = 0;
+        while (offset < clauses_size_) {
+            const uint32_t* const p_clause = _clauses_offset_clause(clauses_data_, offset);
+            if (_clause_is_included(p_clause) && !_clause_is_aggregated(p_clause)) {
+                append_long_clause(offset);
+            };
+            _clauses_offset_next(offset, p_clause);
+        };
+        
+        subsumption_effort_ = CnfEffort(get_cnf_effort_limits().subsumptions);
+        if (!long_offsets_.empty()) {
+            offset = 0;
+            // stopping early leaves the clauses unchanged or strengthened by resolvents
+            while (offset < clauses_size_ && !subsumption_effort_.is_exhausted()) {
+                const clause_size_t clause_size = _clauses_offset_size(clauses_data_, offset);
+                process_long_subsumption(offset);
+                while (!subsuming_changed_.empty()) {
+                    const container_offset_t changed_offset = subsuming_changed_.back();
+                    subsuming_changed_.pop_back();
+                    process_long_subsumption(changed_offset);
+                };
+                _clauses_offset_size_next(offset, clause_size);
+            };
+        };
+        
+        subsuming_changed_.clear();
+        long_offsets_.clear();
+        long_signatures_.clear();
+        long_occurrences_.clear();
+    };
+    
     // check for subsumption within clause_index_
     inline processor_result_t CnfSubsumptionOptimizer::process_clause_subsumption(uint32_t* const p_clause) {
         const clause_size_t clause_size = _clause_size(p_clause);
@@ -156,6 +345,8 @@ namespace bal {
     };
     
     bool CnfSubsumptionOptimizer::execute() {
+        // resolvents of long clauses are subsumed by aggregated clauses below
+        process_long_subsumption();
         process_clauses<CnfSubsumptionOptimizer, &CnfSubsumptionOptimizer::process_clause_subsumption>(this);
         return true;
     };
@@ -9,11 +9,37 @@
 #define cnfsubsumption_hpp
 
 #include "cnfprocessor.hpp"
+#include "cnfeffort.hpp"
 
 namespace bal {
 
+    // long clauses are subsumed and strengthened by self-subsuming resolution beforehand,
+    // by any included clause or aggregated clause member, within the subsumptions budget
     class CnfSubsumptionOptimizer: public CnfProcessor {
+    protected:
+        // long clauses checked against another clause
+        CnfEffort subsumption_effort_;
+        
     private:
+        // long clauses are referred to by their indexes in the below vectors
+        // signatures have a bit set for each variable modulo 64 to reject candidates cheaply
+        std::vector<container_offset_t> long_offsets_;
+        std::vector<uint64_t> long_signatures_;
+        // indexes of long clauses with each variable, not updated when clauses are excluded
+        std::vector<std::vector<uint32_t>> long_occurrences_;
+        // offset of the clause being checked against long clauses
+        container_offset_t subsuming_offset_;
+        // offsets of existing clauses that have changed and must be checked again
+        std::vector<container_offset_t> subsuming_changed_;
+        
+        inline void append_long_clause(const container_offset_t offset);
+        inline clause_size_t subsume_long_clause(const literalid_t* const literals, const clause_size_t size,
+                                                 const uint32_t* const p_long);
+        inline void strengthen_long_clause(const uint32_t long_index, const clause_size_t literal_index);
+        inline void process_long_subsumption(const literalid_t* const literals, const clause_size_t size);
+        inline void process_long_subsumption(const container_offset_t offset);
+        inline void process_long_subsumption();
+        
         inline processor_result_t process_clause_subsumption(uint32_t* const p_clause);
         
         template<clause_size_t ca_size>
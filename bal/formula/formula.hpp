@@ -140,7 +140,7 @@ namespace bal {
     inline bool evaluate(FORMULA& formula,
                          const char* parameter_name, const VariablesArray& parameter_value,
                          const char* result_name, VariablesArray& result_value) {
-        VariablesArray variables(formula.variables_size());
+        VariablesArray variables(formula.variables_size(), 1);
         variables.assign_sequence();
         if (variables.assign_template_from(formula.get_named_variables().at(parameter_name), parameter_value) == VARIABLEID_ERROR) {
             throw std::invalid_argument("Conflicting binary variable assignment");
@@ -159,7 +159,7 @@ namespace bal {
     inline bool process(FORMULA& formula,
                         const char* parameter_name, const VariablesArray& parameter_value,
                         const bool b_reindex_variables, const FormulaProcessingMode mode) {
-        VariablesArray variables(formula.variables_size());
+        VariablesArray variables(formula.variables_size(), 1);
         variables.assign_sequence();
         if (variables.assign_template_from(formula.get_named_variables().at(parameter_name), parameter_value) == VARIABLEID_ERROR) {
             throw std::invalid_argument("Conflicting binary variable assignment");
@@ -6,6 +6,7 @@
 //
 
 #include <stdexcept>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include "commandline.hpp"
@@ -13,7 +14,7 @@
 #include "sha256.hpp"
 #include "cnfencoding.hpp"
 
-constexpr size_t APP_OPTIONS_SIZE = 15;
+constexpr size_t APP_OPTIONS_SIZE = 30;
 constexpr const char* const APP_OPTIONS[APP_OPTIONS_SIZE] = {
     "f", "v", "r",
     "add_max_args", "xor_max_args",
@@ -23,6 +24,15 @@ constexpr const char* const APP_OPTIONS[APP_OPTIONS_SIZE] = {
     "n", "normalize_variables",
     "m",
     "t", "trace",
+    "e", "eliminate_variables",
+    "p", "probe",
+    "x", "xor",
+    "propagations_max", "resolvents_max", "subsumptions_max",
+    "time_limit",
+    "passes", "pass_rounds",
+    "core",
+    "threads",
+    "eliminate_named",
 };
 
 void print_arg_ignore(const char* const message, const char* const arg) {
@@ -341,6 +351,87 @@ void CGenCommandLineReader::parse(CGenCommandInfo& info) {
                         parse_error(ERROR_TRACE_UNKNOWN_VALUE);
                     };
                     break;
+                case 15:
+                case 16: // eliminate_variables
+                    info.b_eliminate_variables_specified = true;
+                    break;
+                case 17:
+                case 18: // probe
+                    info.b_probe_specified = true;
+                    if (is_symbol('=')) {
+                        read_symbol('=');
+                        info.probe_variable_name = read_literal();
+                    };
+                    break;
+                case 19:
+                case 20: // xor
+                    info.b_xor_specified = true;
+                    break;
+                case 21: // propagations_max
+                    read_symbol('=');
+                    info.effort_limits.propagations = read_uint32(1, UINT32_MAX);
+                    info.b_effort_limits_specified = true;
+                    break;
+                case 22: // resolvents_max
+                    read_symbol('=');
+                    info.effort_limits.resolvents = read_uint32(1, UINT32_MAX);
+                    info.b_effort_limits_specified = true;
+                    break;
+                case 23: // subsumptions_max
+                    read_symbol('=');
+                    info.effort_limits.subsumptions = read_uint32(1, UINT32_MAX);
+                    info.b_effort_limits_specified = true;
+                    break;
+                case 24: // time_limit
+                    read_symbol('=');
+                    info.effort_limits.seconds = read_uint32(1, UINT32_MAX);
+                    info.b_effort_limits_specified = true;
+                    break;
+                case 25: // passes
+                    read_symbol('=');
+                    info.b_passes_specified = true;
+                    info.passes.clear();
+                    while (true) {
+                        if (is_token("o") || is_token("optimize")) {
+                            info.passes.push_back(cpOptimize);
+                        } else if (is_token("s") || is_token("subsume")) {
+                            info.passes.push_back(cpSubsume);
+                        } else if (is_token("x") || is_token("xor")) {
+                            info.passes.push_back(cpXor);
+                        } else if (is_token("p") || is_token("probe")) {
+                            info.passes.push_back(cpProbe);
+                        } else if (is_token("e") || is_token("eliminate")) {
+                            info.passes.push_back(cpEliminate);
+                        } else if (is_token("u") || is_token("pure")) {
+                            info.passes.push_back(cpPure);
+                        } else if (is_token("b") || is_token("blocked")) {
+                            info.passes.push_back(cpBlocked);
+                        } else {
+                            parse_error(ERROR_PASSES_UNKNOWN_VALUE);
+                        };
+                        skip_token();
+                        if (!is_symbol(',')) {
+                            break;
+                        };
+                        read_symbol(',');
+                    };
+                    break;
+                case 26: // pass_rounds
+                    read_symbol('=');
+                    info.pass_rounds = read_uint32(1, UINT32_MAX);
+                    info.b_passes_specified = true;
+                    break;
+                case 27: // core
+                    info.b_core_specified = true;
+                    break;
+                case 28: // threads
+                    read_symbol('=');
+                    info.threads = read_uint32(1, UINT32_MAX);
+                    info.b_threads_specified = true;
+                    break;
+                case 29: // eliminate_named
+                    info.b_eliminate_named = true;
+                    break;
                 default:
                     print_arg_ignore(ERROR_UNKNOWN_OPTION, get_current_line());
                     read_until_eol();
@@ -445,6 +536,85 @@ void CGenCommandLineReader::parse(CGenCommandInfo& info) {
         };
     };
     
+    if (info.b_eliminate_variables_specified) {
+        if (info.command != cmdEncode && info.command != cmdProcess) {
+            parse_error(ERROR_ELIMINATE_VARIABLES_MUST_FOLLOW_ENCODE_PROCESS);
+        };
+        if (info.formula_type != ftCnf) {
+            parse_error(ERROR_ELIMINATE_VARIABLES_CNF_ONLY);
+        };
+    };
+    
+    if (info.b_probe_specified) {
+        if (info.command != cmdEncode && info.command != cmdProcess) {
+            parse_error(ERROR_PROBE_MUST_FOLLOW_ENCODE_PROCESS);
+        };
+        if (info.formula_type != ftCnf) {
+            parse_error(ERROR_PROBE_CNF_ONLY);
+        };
+    };
+    
+    if (info.b_xor_specified) {
+        if (info.command != cmdEncode && info.command != cmdProcess) {
+            parse_error(ERROR_XOR_MUST_FOLLOW_ENCODE_PROCESS);
+        };
+        if (info.formula_type != ftCnf) {
+            parse_error(ERROR_XOR_CNF_ONLY);
+        };
+    };
+    
+    if (info.b_passes_specified) {
+        if (info.command != cmdEncode && info.command != cmdProcess) {
+            parse_error(ERROR_PASSES_MUST_FOLLOW_ENCODE_PROCESS);
+        };
+        if (info.formula_type != ftCnf) {
+            parse_error(ERROR_PASSES_CNF_ONLY);
+        };
+    } else {
+        // each technique runs once as specified
+        info.pass_rounds = 1;
+    };
+    
+    // techniques specified by their own options follow the listed passes, unless listed
+    const bool b_pass_options[] = { info.b_xor_specified, info.b_probe_specified, info.b_eliminate_variables_specified };
+    const CGenPass pass_options[] = { cpXor, cpProbe, cpEliminate };
+    for (auto i = 0; i < 3; i++) {
+        if (b_pass_options[i] && std::find(info.passes.begin(), info.passes.end(), pass_options[i]) == info.passes.end()) {
+            info.passes.push_back(pass_options[i]);
+        };
+    };
+    
+    if (info.b_eliminate_named && std::find(info.passes.begin(), info.passes.end(), cpEliminate) == info.passes.end()) {
+        parse_error(ERROR_ELIMINATE_NAMED_REQUIRES_ELIMINATION);
+    };
+    
+    if (info.b_effort_limits_specified) {
+        if (info.command != cmdEncode && info.command != cmdProcess) {
+            parse_error(ERROR_EFFORT_LIMITS_MUST_FOLLOW_ENCODE_PROCESS);
+        };
+        if (info.formula_type != ftCnf) {
+            parse_error(ERROR_EFFORT_LIMITS_CNF_ONLY);
+        };
+    };
+    
+    if (info.b_threads_specified) {
+        if (info.command != cmdEncode && info.command != cmdProcess) {
+            parse_error(ERROR_THREADS_MUST_FOLLOW_ENCODE_PROCESS);
+        };
+        if (info.formula_type != ftCnf) {
+            parse_error(ERROR_THREADS_CNF_ONLY);
+        };
+    };
+    
+    if (info.b_core_specified) {
+        if (info.command != cmdProcess) {
+            parse_error(ERROR_CORE_MUST_FOLLOW_PROCESS);
+        };
+        if (info.formula_type != ftCnf) {
+            parse_error(ERROR_CORE_CNF_ONLY);
+        };
+    };
+    
     if (info.b_mode_assigned) {
         if (info.command != cmdEncode && info.command != cmdProcess) {
             parse_error(ERROR_MODE_UNSUPPORTED_COMMAND);
@@ -12,6 +12,7 @@
 #include "commandlinereader.hpp"
 #include "variablesio.hpp"
 #include "cnf.hpp"
+#include "cnfeffort.hpp"
 
 typedef struct CGenCommandInfo {
     CGenCommand command = cmdNone;
@@ -29,6 +30,19 @@ typedef struct CGenCommandInfo {
     bool b_assign_after_encoding = false;
     bool b_reindex_variables = true;
     bool b_normalize_variables_specified = false;
+    bool b_eliminate_variables_specified = false;
+    bool b_eliminate_named = false;
+    bool b_probe_specified = false;
+    std::string probe_variable_name;
+    bool b_xor_specified = false;
+    bool b_passes_specified = false;
+    CGenPasses passes;
+    uint32_t pass_rounds = 0; // zero means unassigned
+    bool b_effort_limits_specified = false;
+    bal::CnfEffortLimits effort_limits;
+    bool b_threads_specified = false;
+    uint32_t threads = 0; // zero means all hardware threads
+    bool b_core_specified = false;
     bool b_mode_assigned = false;
     bal::FormulaProcessingMode mode = bal::fpmOriginal;
 } CGenCommandInfo;
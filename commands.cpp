@@ -17,6 +17,13 @@
 #include "cnf.hpp"
 #include "cnfencoding.hpp"
 #include "cnfoptimizer.hpp"
+#include "cnfcomponents.hpp"
+#include "cnfeliminator.hpp"
+#include "cnfblocker.hpp"
+#include "cnfprober.hpp"
+#include "cnfgaussian.hpp"
+#include "cnfscheduler.hpp"
+#include "cnfexplainer.hpp"
 #include "cnfdimacs.hpp"
 #include "cnfgexf.hpp"
 #include "cnfgraphml.hpp"
@@ -62,6 +69,69 @@ void print_statistics(const bal::Anf& anf) {
     };
 };
 
+// runs the processing techniques through the scheduler
+bool process_passes(bal::Cnf& cnf, const CGenPasses& passes, const uint32_t pass_rounds,
+                    const std::string& probe_variable_name, const bool b_eliminate_named,
+                    const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+    bal::CnfPassScheduler scheduler(pass_rounds);
+    for (auto pass: passes) {
+        switch(pass) {
+            case cpOptimize:
+                scheduler.register_pass("optimize", [](bal::Cnf& cnf, const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+                    bal::VariablesArray variables(cnf.variables_size(), 1);
+                    variables.assign_sequence();
+                    return bal::process(cnf, variables, b_reindex_variables, mode);
+                }, true);
+                break;
+            case cpSubsume:
+                scheduler.register_pass("subsume", [](bal::Cnf& cnf, const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+                    return bal::subsume_clauses(cnf, b_reindex_variables);
+                }, true);
+                break;
+            case cpXor:
+                scheduler.register_pass("xor", bal::eliminate_xors, false);
+                break;
+            case cpProbe:
+                scheduler.register_pass("probe", [&probe_variable_name](bal::Cnf& cnf, const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+                    return bal::probe_literals(cnf, b_reindex_variables, mode, probe_variable_name);
+                }, false);
+                break;
+            case cpEliminate:
+                scheduler.register_pass("eliminate", [b_eliminate_named](bal::Cnf& cnf, const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+                    // bits of the message and the hash are kept unless asked otherwise
+                    const std::vector<std::string> protected_names = b_eliminate_named ?
+                        std::vector<std::string>() : std::vector<std::string>({ "M", "H" });
+                    return bal::eliminate_variables(cnf, b_reindex_variables, protected_names);
+                }, false);
+                break;
+            case cpPure:
+                scheduler.register_pass("pure", [](bal::Cnf& cnf, const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+                    return bal::eliminate_pure_literals(cnf, b_reindex_variables);
+                }, true);
+                break;
+            case cpBlocked:
+                scheduler.register_pass("blocked", [](bal::Cnf& cnf, const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+                    return bal::eliminate_blocked_clauses(cnf, b_reindex_variables);
+                }, false);
+                break;
+        };
+    };
+    bool result = scheduler.execute(cnf, b_reindex_variables, mode);
+    
+    // once no clauses remain, any values satisfy the formula; those of the removed clauses are reconstructed
+    if (result && cnf.clauses_size() == 0 && !cnf.reconstruction().is_empty()) {
+        bal::VariablesArray model(cnf.variables_size(), 1);
+        for (bal::variableid_t i = 0; i < model.size(); i++) {
+            model.data()[i] = bal::LITERAL_CONST_0;
+        };
+        bal::VariablesArray values;
+        cnf.reconstruction().reconstruct(model, values);
+        cnf.reconstruction().clear();
+        cnf.named_variables_update(values);
+    };
+    return result;
+};
+
 template<class Formula, class Reader>
 void load_impl(Formula& formula, const char* const file_name) {
     std::cout << "Input file: " << file_name << std::endl;
@@ -415,9 +485,11 @@ void variables_store_computed(const bal::Formula& formula,
 };
 
 // variables_map - contains variable values without except options applied
+// p_assignment - receives the variable values assigned in the formula if specified
 template<class FORMULA, bool ONLY_IF_CHANGED = false>
 bool process_impl(FORMULA& formula, CGenVariablesMap& variables_map,
-                  const bool b_reindex_variables, const bal::FormulaProcessingMode mode) {
+                  const bool b_reindex_variables, const bal::FormulaProcessingMode mode,
+                  bal::VariablesArray* const p_assignment = nullptr) {
     static_assert(std::is_base_of<bal::Formula, FORMULA>::value, "FORMULA must be a descendant of bal::Formula");
     
     // all variable values will be mapped to a single array
@@ -444,18 +516,23 @@ bool process_impl(FORMULA& formula, CGenVariablesMap& variables_map,
         if (changes_count > 0) {
             std::cout << "Assigning " << std::dec << changes_count << " variable(s) in the formula" << std::endl;
         };
+        if (p_assignment != nullptr) {
+            *p_assignment = variables;
+        };
         return process(formula, variables, b_reindex_variables, mode);
     } else {
         return true;
     };
 };
 
-template<class SHA>
+// process_passes is called with the encoded formula, the passes are specific to CNF
+template<class SHA, typename PROCESS_PASSES>
 void encode_impl(typename SHA::Bit::Formula& formula, const uint32_t rounds,
                  CGenVariablesMap& variables_map,
                  const uint32_t add_max_args, const uint32_t xor_max_args,
                  const char* const output_file_name, const CGenOutputFormat output_format,
                  const bool b_reindex_variables, const bool b_normalize_variables,
+                 const PROCESS_PASSES& process_passes,
                  const bool b_assign_after_encoding, const bal::FormulaProcessingMode mode) {
 
     if (rounds == 0 || rounds > SHA::ROUNDS_NUMBER) {
@@ -536,6 +613,10 @@ void encode_impl(typename SHA::Bit::Formula& formula, const uint32_t rounds,
         is_valid = process_impl<typename SHA::Bit::Formula, true>(formula, variables_map, b_reindex_variables, mode);
     };
     
+    if (is_valid) {
+        is_valid = process_passes(formula);
+    };
+    
     if (is_valid && b_normalize_variables) {
         normalize_variables(formula, b_reindex_variables);
     };
@@ -556,17 +637,22 @@ void encode_anf(const CGenAlgorithm algorithm, const uint32_t rounds,
                 const bool b_assign_after_encoding, const bal::FormulaProcessingMode mode) {    
     bal::Anf anf;
     
+    // the passes are specific to CNF, the command line rejects them for ANF
+    const auto process_anf_passes = [](bal::Anf& anf) { return true; };
+    
     switch(algorithm) {
         case algSHA1:
             encode_impl<acl::SHA1<bal::Literal<bal::Anf>>>(anf, rounds, variables_map, add_max_args, xor_max_args,
                                                        output_file_name, output_format,
                                                        b_reindex_variables, b_normalize_variables,
+                                                       process_anf_passes,
                                                        b_assign_after_encoding, mode);
             break;
         case algSHA256:
             encode_impl<acl::SHA256<bal::Literal<bal::Anf>>>(anf, rounds, variables_map, add_max_args, xor_max_args,
                                                          output_file_name, output_format,
                                                          b_reindex_variables, b_normalize_variables,
+                                                         process_anf_passes,
                                                          b_assign_after_encoding, mode);
             break;
         default:
@@ -613,24 +699,34 @@ void encode_cnf(const CGenAlgorithm algorithm, const uint32_t rounds,
                 const char* const output_file_name,
                 const CGenOutputFormat output_format, const CGenTraceFormat trace_format,
                 const bool b_reindex_variables, const bool b_normalize_variables,
+                const CGenPasses& passes, const uint32_t pass_rounds, const std::string& probe_variable_name,
+                const bool b_eliminate_named,
                 const bool b_assign_after_encoding, const bal::FormulaProcessingMode mode) {
+    // the formula grows large, its clauses are never moved while appended
     bal::Cnf cnf;
+    cnf.set_clauses_allocation(bal::caVirtual);
     
     cnf.add_parameter("encoder", "add_args_structure", "chain");
     cnf.add_parameter("encoder", "add_args_order", "none");
     
+    const auto process_cnf_passes = [&](bal::Cnf& cnf) {
+        return process_passes(cnf, passes, pass_rounds, probe_variable_name, b_eliminate_named, b_reindex_variables, mode);
+    };
+    
     __CNF_TRACE_INITIALIZE(trace_format, output_file_name);
     switch(algorithm) {
         case algSHA1:
             encode_impl<acl::SHA1<bal::Literal<bal::Cnf>>>(cnf, rounds, variables_map, add_max_args, xor_max_args,
                                                        output_file_name, output_format,
                                                        b_reindex_variables, b_normalize_variables,
+                                                       process_cnf_passes,
                                                        b_assign_after_encoding, mode);
             break;
         case algSHA256:
             encode_impl<acl::SHA256<bal::Literal<bal::Cnf>>>(cnf, rounds, variables_map, add_max_args, xor_max_args,
                                                          output_file_name, output_format,
                                                          b_reindex_variables, b_normalize_variables,
+                                                         process_cnf_passes,
                                                          b_assign_after_encoding, mode);
             break;
         default:
@@ -665,21 +761,77 @@ void process_anf(CGenVariablesMap& variables_map,
     };
 };
 
+// outputs the named variables bits the conflict of the assignment with the formula follows from
+// in the same form as their values, other bits unassigned
+void print_core(bal::Cnf& cnf, bal::VariablesArray& assignment) {
+    std::cout << "Explaining the conflict" << std::endl;
+    bal::CnfConflictExplainer explainer(cnf, assignment);
+    if (!explainer.execute()) {
+        std::cout << "Core: not found by evaluation" << std::endl;
+        return;
+    };
+    
+    bal::variables_size_t core_size = 0;
+    for (auto i = 0; i < assignment.size(); i++) {
+        if (literal_t__is_constant(assignment.data()[i])) {
+            core_size++;
+        };
+    };
+    std::cout << "Core: " << std::dec << core_size << " variable(s), ";
+    if (explainer.is_propagated()) {
+        std::cout << "by propagation" << std::endl;
+    } else {
+        std::cout << explainer.evaluations() << " evaluation(s)" << std::endl;
+    };
+    
+    for (auto it: cnf.get_named_variables()) {
+        bal::VariablesArray value(it.second);
+        assignment.assign_template_into(it.second, value);
+        bal::variables_size_t value_size = 0;
+        for (auto i = 0; i < value.size(); i++) {
+            if (literal_t__is_variable(it.second.data()[i]) && literal_t__is_constant(value.data()[i])) {
+                value_size++;
+            } else {
+                value.data()[i] = bal::LITERALID_UNASSIGNED;
+            };
+        };
+        if (value_size > 0) {
+            std::cout << "Core " << it.first << " = " << value << std::endl;
+        };
+    };
+};
+
 void process_cnf(CGenVariablesMap& variables_map,
             const char* const input_file_name, const char* const output_file_name,
             const CGenOutputFormat output_format, const CGenTraceFormat trace_format,
             const bool b_reindex_variables, const bool b_normalize_variables,
-            const bal::FormulaProcessingMode mode) {
+            const CGenPasses& passes, const uint32_t pass_rounds, const std::string& probe_variable_name,
+            const bool b_eliminate_named,
+            const bool b_core, const bal::FormulaProcessingMode mode) {
+    // clauses are never moved while appended; a reserved range is shared with the snapshot below
     bal::Cnf cnf;
+    cnf.set_clauses_allocation(bal::caVirtual);
     load_impl<bal::Cnf, bal::DimacsStreamReader>(cnf, input_file_name);
     variables_define(cnf, variables_map);
     
     bool is_valid = true;
     
+    // the conflict is explained against the formula as loaded
+    bal::Cnf original;
+    bal::VariablesArray assignment;
+    if (b_core) {
+        cnf.share();
+        original.snapshot(cnf);
+    };
+    
     __CNF_TRACE_INITIALIZE(trace_format, output_file_name);
-    is_valid = process_impl(cnf, variables_map, b_reindex_variables, mode);
+    is_valid = process_impl(cnf, variables_map, b_reindex_variables, mode, b_core ? &assignment : nullptr);
     __CNF_TRACE_FINIALIZE;
     
+    if (is_valid) {
+        is_valid = process_passes(cnf, passes, pass_rounds, probe_variable_name, b_eliminate_named, b_reindex_variables, mode);
+    };
+    
     if (is_valid && b_normalize_variables) {
         is_valid = normalize_variables(cnf, b_reindex_variables);
     };
@@ -689,6 +841,9 @@ void process_cnf(CGenVariablesMap& variables_map,
             save(cnf, output_file_name, output_format);
         };
     } else {
+        if (b_core && assignment.size() == original.variables_size()) {
+            print_core(original, assignment);
+        };
         throw std::invalid_argument("Processing failed");
     };
 };
@@ -25,6 +25,8 @@ void encode_cnf(const CGenAlgorithm algorithm, const uint32_t rounds,
                 const char* const output_file_name,
                 const CGenOutputFormat output_format, const CGenTraceFormat trace_format,
                 const bool b_reindex_variables, const bool b_normalize_variables,
+                const CGenPasses& passes, const uint32_t pass_rounds, const std::string& probe_variable_name,
+                const bool b_eliminate_named,
                 const bool b_assign_after_encoding, const bal::FormulaProcessingMode mode);
 
 void process_anf(CGenVariablesMap& variables_map,
@@ -37,6 +39,8 @@ void process_cnf(CGenVariablesMap& variables_map,
                  const char* const input_file_name, const char* const output_file_name,
                  const CGenOutputFormat output_format, const CGenTraceFormat trace_format,
                  const bool b_reindex_variables, const bool b_normalize_variables,
-                 const bal::FormulaProcessingMode mode);
+                 const CGenPasses& passes, const uint32_t pass_rounds, const std::string& probe_variable_name,
+                 const bool b_eliminate_named,
+                 const bool b_core, const bal::FormulaProcessingMode mode);
 
 #endif /* commands_hpp */
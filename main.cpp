@@ -10,6 +10,7 @@
 #include "shared.hpp"
 #include "commandline.hpp"
 #include "commands.hpp"
+#include "cnfcomponents.hpp"
 
 void print_version() {
     std::cout << APP_TITLE << " version " << APP_VERSION << std::endl;
@@ -101,6 +102,8 @@ int main(int argc, const char * argv[]) {
         CGenCommandInfo info;
         CGenCommandLineReader command_line_reader(argc, argv);
         command_line_reader.parse(info);
+        bal::set_cnf_effort_limits(info.effort_limits);
+        bal::set_cnf_threads(info.threads);
         
         switch(info.command) {
             case cmdNone:
@@ -128,6 +131,8 @@ int main(int argc, const char * argv[]) {
                                info.output_format, info.trace_format,
                                info.b_reindex_variables,
                                info.b_normalize_variables_specified,
+                               info.passes, info.pass_rounds, info.probe_variable_name,
+                               info.b_eliminate_named,
                                info.b_assign_after_encoding,
                                info.mode);
                 } else if (info.formula_type == ftAnf) {
@@ -152,7 +157,10 @@ int main(int argc, const char * argv[]) {
                     process_cnf(info.variables_map,
                                 info.input_file_name.data(), info.output_file_name.data(),
                                 info.output_format, info.trace_format,
-                                info.b_reindex_variables, info.b_normalize_variables_specified, info.mode);
+                                info.b_reindex_variables, info.b_normalize_variables_specified,
+                                info.passes, info.pass_rounds, info.probe_variable_name,
+                                info.b_eliminate_named,
+                                info.b_core_specified, info.mode);
                 } else if (info.formula_type == ftAnf) {
                     process_anf(info.variables_map,
                                 info.input_file_name.data(), info.output_file_name.data(),
@@ -36,6 +36,18 @@ Options:\n\
         refer for detailed specifications online\n\
     -r <value> - number of SHA1 rounds to encode\n\
     -m ((unoptimized | u) | (all | a) | (original | o)) - processing mode\n\
+    -e | --eliminate_variables - eliminate variables by clause distribution, except bits of M and H (CNF)\n\
+    --eliminate_named - eliminate bits of M and H as well, their values are reconstructed once no clauses remain (CNF)\n\
+    -p | --probe[=<name>] - probe variables, optionally those of the named variable only, for values and equivalences (CNF)\n\
+    -x | --xor - recover XOR clauses and derive values, equivalences and shorter XOR clauses by Gaussian elimination (CNF)\n\
+    --propagations_max=<value> --resolvents_max=<value> --subsumptions_max=<value> - effort budgets of each technique run (CNF)\n\
+    --time_limit=<seconds> - wall-clock time after which the techniques stop, the formula is still output (CNF)\n\
+    --passes=<pass>[,<pass>]... - techniques to repeat in the listed order until the formula stops changing:\n\
+        (optimize | o), (subsume | s), (xor | x), (probe | p), (eliminate | e),\n\
+        (pure | u) - pure literal elimination, (blocked | b) - blocked clause elimination; -e, -p and -x add theirs if not listed (CNF)\n\
+    --pass_rounds=<value> - maximum number of times the passes are repeated, 16 if not specified (CNF)\n\
+    --core - if the assigned variables conflict with the formula, output those the conflict follows from (CNF)\n\
+    --threads=<value> - number of threads processing connected components of the formula, all hardware threads if not specified (CNF)\n\
     -h | --help\n\
     --version\n\
 Further documentation and usage examples available at https://cgen.sophisticatedways.net.\n\
@@ -75,6 +87,28 @@ Further documentation and usage examples available at https://cgen.sophisticated
 #define ERROR_V_MUST_FOLLOW_ENCODE_PROCESS "Variable options can only be specified for \"encode\" and \"process\" commands"
 #define ERROR_NORMALIZE_VARIABLES_MUST_FOLLOW_ENCODE_PROCESS \
     "\"normaize variables\" option may only be specified for \"encode\" or \"process\" command"
+#define ERROR_ELIMINATE_VARIABLES_MUST_FOLLOW_ENCODE_PROCESS \
+    "\"eliminate variables\" option may only be specified for \"encode\" or \"process\" command"
+#define ERROR_ELIMINATE_VARIABLES_CNF_ONLY "\"eliminate variables\" option is only supported for CNF"
+#define ERROR_ELIMINATE_NAMED_REQUIRES_ELIMINATION "\"eliminate named\" option requires variable elimination"
+#define ERROR_PROBE_MUST_FOLLOW_ENCODE_PROCESS \
+    "\"probe\" option may only be specified for \"encode\" or \"process\" command"
+#define ERROR_PROBE_CNF_ONLY "\"probe\" option is only supported for CNF"
+#define ERROR_XOR_MUST_FOLLOW_ENCODE_PROCESS \
+    "\"xor\" option may only be specified for \"encode\" or \"process\" command"
+#define ERROR_XOR_CNF_ONLY "\"xor\" option is only supported for CNF"
+#define ERROR_PASSES_MUST_FOLLOW_ENCODE_PROCESS \
+    "\"passes\" options may only be specified for \"encode\" or \"process\" command"
+#define ERROR_PASSES_CNF_ONLY "\"passes\" options are only supported for CNF"
+#define ERROR_PASSES_UNKNOWN_VALUE "Unknown pass, expect one of optimize (o), subsume (s), xor (x), probe (p), eliminate (e), pure (u), blocked (b)"
+#define ERROR_CORE_MUST_FOLLOW_PROCESS "\"core\" option may only be specified for \"process\" command"
+#define ERROR_CORE_CNF_ONLY "\"core\" option is only supported for CNF"
+#define ERROR_EFFORT_LIMITS_MUST_FOLLOW_ENCODE_PROCESS \
+    "effort limit options may only be specified for \"encode\" or \"process\" command"
+#define ERROR_EFFORT_LIMITS_CNF_ONLY "effort limit options are only supported for CNF"
+#define ERROR_THREADS_MUST_FOLLOW_ENCODE_PROCESS \
+    "\"threads\" option may only be specified for \"encode\" or \"process\" command"
+#define ERROR_THREADS_CNF_ONLY "\"threads\" option is only supported for CNF"
 #define ERROR_MISSING_INPUT_FILE_NAME "Input file name is not specified"
 #define ERROR_INPUT_FILE_FORMAT_MISMATCH "Input file extension does not match the specified format"
 #define ERROR_OUTPUT_FILE_FORMAT_MISMATCH "Output format is incompatible with the formula"
@@ -113,6 +147,7 @@ enum CGenAlgorithm {algNone, algSHA1, algSHA256};
 enum CGenFormulaType {ftCnf, ftAnf};
 enum CGenOutputFormat {ofAnfPolybori, ofCnfDimacs, ofCnfVIGGraphML, ofCnfWeightedVIGGraphML, ofCnfVIGGEXF};
 enum CGenTraceFormat {tfNone, tfNativeStdOut, tfNativeFile, tfCnfVIGGEXF};
+enum CGenPass {cpOptimize, cpSubsume, cpXor, cpProbe, cpEliminate, cpPure, cpBlocked};
 
 enum CGenVariableMode {vmValue, vmRandom, vmCompute};
 enum CGenVariableComputeMode {vcmComplete, vcmDifference, vcmConstant};
@@ -133,6 +168,9 @@ inline bool is_binary_variable_name(const std::string& value) {
 
 typedef std::map<std::string, CGenVariableInfo> CGenVariablesMap;
 
+// processing techniques run after variables are assigned, in the listed order
+typedef std::vector<CGenPass> CGenPasses;
+
 inline const char* const get_formula_type_title(const CGenFormulaType value) {
     switch(value) {
         case ftCnf: